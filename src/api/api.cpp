@@ -38,6 +38,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/pass_profile.hpp>
 #include <array>
 #include <algorithm>
 #include <cstdarg>
@@ -147,6 +148,18 @@ void set_exhaustive_tune_flag(compile_options& options, bool value)
     options.exhaustive_tune = value;
 }
 
+void set_profile_passes(compile_options& options, bool value)
+{
+    options.profile = value ? std::make_shared<pass_profile>() : nullptr;
+}
+
+std::string get_pass_profile(const compile_options& options)
+{
+    if(options.profile == nullptr)
+        return {};
+    return to_json_string(options.profile->to_value());
+}
+
 void set_file_format(file_options& options, const char* format) { options.format = format; }
 
 void set_default_dim_value(onnx_options& options, size_t value)
@@ -287,6 +300,11 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(const execution_session& s, const parameter_map& params)
+{
+    return s.eval(params);
+}
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
@@ -609,6 +627,17 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_execution_session;
+struct migraphx_execution_session
+{
+    template <class... Ts>
+    migraphx_execution_session(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::execution_session object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -1757,6 +1786,51 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_execution_session_destroy(migraphx_execution_session_t execution_session)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((execution_session)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_assign_to(migraphx_execution_session_t output,
+                                     const_migraphx_execution_session_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_create(migraphx_execution_session_t* execution_session,
+                                  const_migraphx_program_t p)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        *execution_session = object_cast<migraphx_execution_session_t>(
+            allocate<migraphx::execution_session>((p->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_run(migraphx_arguments_t* out,
+                               const_migraphx_execution_session_t execution_session,
+                               migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(execution_session == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter execution_session: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_arguments_t>(
+            migraphx::run((execution_session->object), (params->object)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
@@ -2014,6 +2088,47 @@ migraphx_compile_options_set_exhaustive_tune_flag(migraphx_compile_options_t com
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_compile_options_set_profile_passes(migraphx_compile_options_t compile_options, bool value)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(compile_options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter compile_options: Null pointer");
+        migraphx::set_profile_passes((compile_options->object), (value));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_compile_options_pass_profile_size(size_t* out,
+                                           const_migraphx_compile_options_t compile_options)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(compile_options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter compile_options: Null pointer");
+        *out = migraphx::get_pass_profile((compile_options->object)).size();
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_compile_options_get_pass_profile(
+    char* out, size_t out_size, migraphx_compile_options_t compile_options)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(out == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter out: Null pointer");
+        if(compile_options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter compile_options: Null pointer");
+        auto&& api_result = migraphx::get_pass_profile((compile_options->object));
+        auto* it = std::copy_n(api_result.begin(), std::min(api_result.size(), out_size - 1), out);
+        *it      = '\0';
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status
 migraphx_parse_onnx(migraphx_program_t* out, const char* name, migraphx_onnx_options_t options)
 {
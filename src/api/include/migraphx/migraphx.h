@@ -116,6 +116,9 @@ typedef const struct migraphx_module* const_migraphx_module_t;
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_execution_session* migraphx_execution_session_t;
+typedef const struct migraphx_execution_session* const_migraphx_execution_session_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -469,6 +472,22 @@ MIGRAPHX_C_EXPORT migraphx_status migraphx_program_equal(bool* out,
 MIGRAPHX_C_EXPORT migraphx_status migraphx_program_experimental_get_context(
     migraphx_context_t* out, const_migraphx_program_t program);
 
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_session_destroy(migraphx_execution_session_t execution_session);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_session_assign_to(migraphx_execution_session_t output,
+                                     const_migraphx_execution_session_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_session_create(migraphx_execution_session_t* execution_session,
+                                  const_migraphx_program_t p);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_session_run(migraphx_arguments_t* out,
+                               const_migraphx_execution_session_t execution_session,
+                               migraphx_program_parameters_t params);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
@@ -548,6 +567,15 @@ migraphx_compile_options_set_fast_math(migraphx_compile_options_t compile_option
 MIGRAPHX_C_EXPORT migraphx_status migraphx_compile_options_set_exhaustive_tune_flag(
     migraphx_compile_options_t compile_options, bool value);
 
+MIGRAPHX_C_EXPORT migraphx_status migraphx_compile_options_set_profile_passes(
+    migraphx_compile_options_t compile_options, bool value);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_compile_options_pass_profile_size(
+    size_t* out, const_migraphx_compile_options_t compile_options);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_compile_options_get_pass_profile(
+    char* out, size_t out_size, migraphx_compile_options_t compile_options);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_parse_onnx(migraphx_program_t* out,
                                                       const char* name,
                                                       migraphx_onnx_options_t options);
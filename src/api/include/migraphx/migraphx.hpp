@@ -1134,6 +1134,26 @@ struct compile_options : MIGRAPHX_HANDLE_BASE(compile_options)
     {
         call(&migraphx_compile_options_set_exhaustive_tune_flag, this->get_handle_ptr(), value);
     }
+
+    /// Record the time and instruction counts of every pass run during compilation
+    void set_profile_passes(bool value = true)
+    {
+        call(&migraphx_compile_options_set_profile_passes, this->get_handle_ptr(), value);
+    }
+
+    /// The passes recorded during compilation as a json string
+    std::string get_pass_profile()
+    {
+        size_t pout;
+        call(&migraphx_compile_options_pass_profile_size, &pout, this->get_handle_ptr());
+        std::string result(pout + 1, '\0');
+        call(&migraphx_compile_options_get_pass_profile,
+             &result[0],
+             result.size(),
+             this->get_handle_ptr());
+        result.resize(pout);
+        return result;
+    }
 };
 
 /// A program represents the all computation graphs to be compiled and executed
@@ -1238,6 +1258,36 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return not(px == py); }
 };
 
+/// Runs a compiled program with its own scratch memory, so the program can be run from several
+/// threads at the same time with a session for each thread
+struct execution_session : MIGRAPHX_HANDLE_BASE(execution_session)
+{
+    execution_session(const program& p)
+    {
+        // The session refers to the program, so it is kept alive until the session is destroyed
+        auto prog = p.get_handle();
+        m_handle  = std::shared_ptr<migraphx_execution_session>(
+            make<migraphx_execution_session>(&migraphx_execution_session_create,
+                                             p.get_handle_ptr()),
+            [prog](migraphx_execution_session* x) {
+                call(&migraphx_execution_session_destroy, x);
+            });
+    }
+
+    MIGRAPHX_HANDLE_CONSTRUCTOR(execution_session)
+
+    /// Run the program using the inputs passed in
+    arguments eval(const program_parameters& pparams) const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_execution_session_run,
+             &pout,
+             this->get_handle_ptr(),
+             pparams.get_handle_ptr());
+        return arguments(pout, own{});
+    }
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
@@ -297,6 +297,17 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def execution_session(h):
+    h.constructor('create', api.params(p='const migraphx::program&'))
+    h.method('run',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             invoke='migraphx::run($@)',
+             returns='std::vector<migraphx::argument>',
+             const=True)
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
@@ -376,6 +387,16 @@ def compile_options(h):
     h.method('set_exhaustive_tune_flag',
              api.params(value='bool'),
              invoke='migraphx::set_exhaustive_tune_flag($@)')
+    h.method('set_profile_passes',
+             api.params(value='bool'),
+             invoke='migraphx::set_profile_passes($@)')
+    h.method('pass_profile_size',
+             invoke='migraphx::get_pass_profile($@).size()',
+             returns='size_t',
+             const=True)
+    h.method('get_pass_profile',
+             invoke='migraphx::get_pass_profile($@)',
+             returns='std::string')
 
 
 api.add_function('migraphx_parse_onnx',
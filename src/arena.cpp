@@ -0,0 +1,130 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/arena.hpp>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <new>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Each chunk is as large as all the previous chunks together, within these limits
+static constexpr std::size_t min_chunk_blocks = 64;
+static constexpr std::size_t max_chunk_blocks = 4096;
+
+arena::~arena()
+{
+    for(auto& c : chunks)
+        ::operator delete(c.data);
+}
+
+static bool data_less(const char* x, const char* y) { return std::less<>{}(x, y); }
+
+std::size_t arena::find_chunk(const void* p) const
+{
+    const auto* x = static_cast<const char*>(p);
+    auto it       = std::upper_bound(chunks.begin(),
+                               chunks.end(),
+                               x,
+                               [](const char* y, const chunk& c) { return data_less(y, c.data); });
+    if(it == chunks.begin())
+        return chunks.size();
+    --it;
+    if(not data_less(x, it->data + it->nblocks * block_size))
+        return chunks.size();
+    return it - chunks.begin();
+}
+
+std::size_t arena::block_index(std::size_t i, const void* p) const
+{
+    return (static_cast<const char*>(p) - chunks[i].data) / block_size;
+}
+
+void* arena::allocate(std::size_t n)
+{
+    if(block_size == 0)
+    {
+        const std::size_t align = alignof(std::max_align_t);
+        block_size              = (n + align - 1) / align * align;
+    }
+    if(n > block_size or n * 2 <= block_size)
+        return ::operator new(n);
+    void* result = nullptr;
+    if(not free_blocks.empty())
+    {
+        result = free_blocks.back();
+        free_blocks.pop_back();
+    }
+    else
+    {
+        if(nunused == 0)
+        {
+            chunk c;
+            c.nblocks = std::clamp(capacity, min_chunk_blocks, max_chunk_blocks);
+            c.data    = static_cast<char*>(::operator new(c.nblocks * block_size));
+            c.live.resize(c.nblocks);
+            next    = c.data;
+            nunused = c.nblocks;
+            capacity += c.nblocks;
+            auto it = std::upper_bound(
+                chunks.begin(), chunks.end(), c.data, [](const char* y, const chunk& x) {
+                    return data_less(y, x.data);
+                });
+            chunks.insert(it, std::move(c));
+        }
+        result = next;
+        next += block_size;
+        nunused--;
+    }
+    auto i = find_chunk(result);
+    assert(i < chunks.size());
+    chunks[i].live[block_index(i, result)] = true;
+    return result;
+}
+
+void arena::deallocate(void* p, std::size_t n)
+{
+    auto i = find_chunk(p);
+    if(i == chunks.size())
+    {
+        ::operator delete(p);
+        return;
+    }
+    assert(n <= block_size);
+    (void)n;
+    chunks[i].live[block_index(i, p)] = false;
+    free_blocks.push_back(p);
+}
+
+bool arena::contains(const void* p) const
+{
+    auto i = find_chunk(p);
+    if(i == chunks.size())
+        return false;
+    return chunks[i].live[block_index(i, p)];
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
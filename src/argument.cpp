@@ -28,10 +28,15 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-argument::argument(const shape& s) : m_shape(s)
+argument::argument(const shape& s) : m_shape(s) { assign_buffer(allocate_host_buffer(s.bytes())); }
+
+argument argument::uninitialized(const shape& s)
 {
-    auto buffer = make_shared_array<char>(s.bytes());
-    assign_buffer({[=]() mutable { return buffer.get(); }});
+    argument result;
+    result.m_shape = s;
+    // Only the elements are written, so the gaps in shapes that aren't packed are still zeroed
+    result.assign_buffer(allocate_host_buffer(s.bytes(), not s.packed()));
+    return result;
 }
 
 argument::argument(shape s, std::nullptr_t)
@@ -41,6 +46,17 @@ argument::argument(shape s, std::nullptr_t)
 
 argument::argument(const shape& s, const argument::data_t& d) : m_shape(s), m_data(d) {}
 
+void argument::assign_buffer(std::shared_ptr<char> b)
+{
+    if(m_shape.type() == shape::tuple_type or b == nullptr)
+    {
+        assign_buffer([b] { return b.get(); });
+        return;
+    }
+    m_data        = {};
+    m_data.buffer = std::move(b);
+}
+
 void argument::assign_buffer(std::function<char*()> d)
 {
     const shape& s = m_shape;
@@ -120,10 +136,15 @@ char* argument::data() const
 {
     assert(m_shape.type() != shape::tuple_type);
     assert(not this->empty());
+    if(m_data.buffer)
+        return m_data.buffer.get();
     return m_data.get();
 }
 
-bool argument::empty() const { return not m_data.get and m_data.sub.empty(); }
+bool argument::empty() const
+{
+    return not m_data.get and not m_data.buffer and m_data.sub.empty();
+}
 
 const shape& argument::get_shape() const { return this->m_shape; }
 
@@ -136,6 +157,7 @@ argument argument::reshape(const shape& s) const
 argument::data_t argument::data_t::share() const
 {
     data_t result;
+    result.buffer = buffer;
     if(this->get)
     {
         auto self  = std::make_shared<data_t>(*this);
@@ -158,8 +180,8 @@ argument::data_t argument::data_t::from_args(const std::vector<argument>& args)
 
 argument argument::copy() const
 {
-    argument result{this->get_shape()};
-    auto* src = this->data();
+    auto result = argument::uninitialized(this->get_shape());
+    auto* src   = this->data();
     std::copy(src, src + this->get_shape().bytes(), result.data());
     return result;
 }
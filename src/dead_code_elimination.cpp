@@ -56,7 +56,7 @@ void dead_code_elimination::apply(module& m) const
            not(i->name().front() == '@') and not contains({"identity", "allocate"}, i->name()) and
            not i->is_undefined())
             continue;
-        assert(std::distance(m.begin(), i) <= std::distance(m.begin(), last));
+        assert(i == last or m.precedes(i, last));
         std::unordered_set<instruction_ref> visited;
         fix([&](auto self, auto leaf) {
             if(not m.has_instruction(leaf))
@@ -70,7 +70,7 @@ void dead_code_elimination::apply(module& m) const
                 std::unordered_set<instruction_ref> args(leaf->inputs().begin(),
                                                          leaf->inputs().end());
                 leaf->clear_arguments();
-                assert(std::distance(m.begin(), leaf) < std::distance(m.begin(), last));
+                assert(m.precedes(leaf, last));
                 assert(leaf != ins);
                 if(leaf->name() != "@param")
                     m.move_instruction(leaf, m.end());
@@ -24,26 +24,35 @@
 #include <migraphx/dom_info.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/iterator_for.hpp>
-#include <migraphx/erase.hpp>
 #include <migraphx/ranges.hpp>
-#include <unordered_set>
+#include <optional>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-bool dominator_info::strictly_dominate(instruction_ref ins1, instruction_ref ins2)
+bool dominator_info::strictly_dominate(instruction_ref ins1, instruction_ref ins2) const
 {
     if(ins1 == ins2)
         return false;
-    auto iter = ins2idom.find(ins2);
-    while(iter != ins2idom.end())
+    if(ins2interval.empty())
     {
-        if(ins1 == iter->second)
-            return true;
-        assert(iter != ins2idom.find(iter->second));
-        iter = ins2idom.find(iter->second);
+        auto iter = ins2idom.find(ins2);
+        while(iter != ins2idom.end())
+        {
+            if(ins1 == iter->second)
+                return true;
+            assert(iter != ins2idom.find(iter->second));
+            iter = ins2idom.find(iter->second);
+        }
+        return false;
     }
-    return false;
+    // A node dominates the nodes visited between entering and leaving it in a walk of the tree
+    auto it1 = ins2interval.find(ins1);
+    auto it2 = ins2interval.find(ins2);
+    if(it1 == ins2interval.end() or it2 == ins2interval.end())
+        return false;
+    return it1->second.first < it2->second.first and it2->second.second < it1->second.second;
 }
 
 struct module_visitor
@@ -54,40 +63,84 @@ struct module_visitor
     const std::vector<instruction_ref>& get_children(instruction_ref ins) { return ins->inputs(); }
 };
 
+// Number the nodes of the dominator tree in the order they are entered and left in a depth-first
+// walk, so dominance can be checked by comparing the numbers
+static void compute_intervals(dominator_info& info)
+{
+    std::unordered_map<instruction_ref, std::vector<instruction_ref>> tree;
+    for(auto&& [ins, idom] : info.ins2idom)
+        tree[idom].push_back(ins);
+    std::size_t n = 0;
+    std::vector<std::pair<instruction_ref, std::size_t>> stack;
+    for(auto&& pp : tree)
+    {
+        auto root = pp.first;
+        if(contains(info.ins2idom, root))
+            continue;
+        stack.emplace_back(root, 0);
+        info.ins2interval[root].first = n++;
+        while(not stack.empty())
+        {
+            auto& [ins, i] = stack.back();
+            auto it        = tree.find(ins);
+            if(it == tree.end() or i == it->second.size())
+            {
+                info.ins2interval[ins].second = n++;
+                stack.pop_back();
+                continue;
+            }
+            auto child = it->second[i++];
+            info.ins2interval[child].first = n++;
+            stack.emplace_back(child, 0);
+        }
+    }
+}
+
+// The inputs of an instruction are its predecessors, so the instructions without inputs are the
+// roots. Since the module is in topological order, the immediate dominator of an instruction is
+// the nearest common dominator of its inputs, which is found by walking up the dominator tree
+// from the later input (Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm").
 template <class Visitor>
 dominator_info compute_dominator_generic(Visitor v)
 {
     dominator_info info;
-    std::unordered_map<instruction_ref, std::unordered_set<instruction_ref>> instr2_doms;
+    // Instructions outside of the module get the rank 0
+    std::unordered_map<instruction_ref, std::size_t> ranks;
+    auto rank = [&](instruction_ref ins) {
+        auto it = ranks.find(ins);
+        return it == ranks.end() ? 0 : it->second;
+    };
+    auto intersect = [&](instruction_ref x, instruction_ref y) -> std::optional<instruction_ref> {
+        while(x != y)
+        {
+            auto& later = rank(x) > rank(y) ? x : y;
+            if(rank(later) == 0)
+                return std::nullopt;
+            auto it = info.ins2idom.find(later);
+            if(it == info.ins2idom.end())
+                return std::nullopt;
+            later = it->second;
+        }
+        return x;
+    };
+    std::size_t n = 0;
     for(instruction_ref ins : iterator_for(v.get_nodes()))
     {
+        ranks[ins] = ++n;
         const std::vector<instruction_ref>& children = v.get_children(ins);
-        if(children.size() == 1)
-        {
-            info.ins2idom[ins] = children.front();
-            instr2_doms[ins].insert(children.front());
-        }
-        else if(children.size() > 1)
+        if(children.empty())
+            continue;
+        std::optional<instruction_ref> idom = children.front();
+        for(auto child : range(children.begin() + 1, children.end()))
         {
-            auto&& doms = instr2_doms[ins];
-
-            doms = instr2_doms[children.front()];
-            std::for_each(children.begin() + 1, children.end(), [&](instruction_ref child) {
-                auto&& child_doms = instr2_doms[child];
-                erase_if(doms, [&](auto x) { return not contains(child_doms, x); });
-            });
-            auto iter = std::find_if(doms.begin(), doms.end(), [&](auto dom1) {
-                return std::none_of(doms.begin(), doms.end(), [&](auto dom2) {
-                    if(dom1 == dom2)
-                        return false;
-                    return info.strictly_dominate(dom1, dom2);
-                });
-            });
-            if(iter != doms.end())
-                info.ins2idom[ins] = *iter;
+            idom = intersect(*idom, child);
+            if(not idom.has_value())
+                break;
         }
-        instr2_doms[ins].insert(ins);
+        if(idom.has_value())
+            info.ins2idom[ins] = *idom;
     }
+    compute_intervals(info);
     return info;
 }
 
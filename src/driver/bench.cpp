@@ -0,0 +1,874 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+#include "models.hpp"
+
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/dfor.hpp>
+#include <migraphx/dom_info.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/gemm.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/host_allocator.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/normalize_ops.hpp>
+#include <migraphx/onnx.hpp>
+#include <migraphx/op/pointwise.hpp>
+#include <migraphx/op/pooling.hpp>
+#include <migraphx/optimize_module.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/propagate_constant.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/split_single_dyn_dim.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/time.hpp>
+#include <migraphx/tmp_dir.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using benchmark_function = std::function<void(std::size_t iterations)>;
+
+template <class F>
+double time_per_iteration(std::size_t iterations, F f)
+{
+    // Warm up
+    f();
+    auto us = time<std::chrono::duration<double, std::micro>>([&] {
+        for(std::size_t i = 0; i < iterations; i++)
+            f();
+    });
+    return us / iterations;
+}
+
+void print_result(const std::string& name, double us)
+{
+    std::cout << std::setw(40) << std::left << name << ": " << us << "us" << std::endl;
+}
+
+// Measures the cost of dispatching a trivial parallel loop, comparing the
+// persistent thread pool to creating and joining a thread per worker
+void bench_par_for(std::size_t iterations)
+{
+    const std::size_t nthreads = thread_pool::global().max_concurrency();
+    std::cout << "Threads: " << nthreads << std::endl;
+    std::atomic<std::size_t> count{0};
+    print_result("spawn threads", time_per_iteration(iterations, [&] {
+                     std::vector<std::thread> threads;
+                     threads.reserve(nthreads);
+                     for(std::size_t i = 0; i < nthreads; i++)
+                         threads.emplace_back([&] { count++; });
+                     for(auto& t : threads)
+                         t.join();
+                 }));
+    print_result("thread_pool::run", time_per_iteration(iterations, [&] {
+                     thread_pool::global().run(nthreads, [&](std::size_t) { count++; });
+                 }));
+    for(std::size_t n : {64, 4096, 262144})
+    {
+        std::vector<float> x(n, 1.0f);
+        print_result("par_for(" + std::to_string(n) + ")", time_per_iteration(iterations, [&] {
+                         par_for(n, [&](std::size_t i) { x[i] += 1.0f; });
+                     }));
+    }
+}
+
+// The previous reference gemm which computed every output element separately
+template <class T, class U>
+void naive_gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat)
+{
+    std::size_t dim_0 = cmat.get_shape().lens().size() - 2;
+    std::size_t dim_1 = dim_0 + 1;
+    auto k            = amat.get_shape().lens()[dim_1];
+    auto cs           = cmat.get_shape();
+    par_for(cs.elements(), [&](auto i) {
+        auto c_idx = cs.multi(i);
+        auto a_idx = c_idx;
+        auto b_idx = c_idx;
+        double s   = 0.0;
+        dfor(k)([&](auto kk) {
+            a_idx[dim_1] = b_idx[dim_0] = kk;
+            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
+                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
+        });
+        cmat(c_idx.begin(), c_idx.end()) = s;
+    });
+}
+
+template <class T, class U>
+void bench_gemm_type(std::size_t iterations, shape::type_t ctype, shape::type_t abtype)
+{
+    for(std::size_t n : {64, 256, 512})
+    {
+        shape as{abtype, {n, n}};
+        shape bs{abtype, {n, n}, {1, n}};
+        shape cs{ctype, {n, n}};
+        std::vector<U> a(as.elements(), U{1});
+        std::vector<U> b(bs.elements(), U{2});
+        std::vector<T> c(cs.elements());
+        tensor_view<T> cv{cs, c.data()};
+        tensor_view<U> av{as, a.data()};
+        tensor_view<U> bv{bs, b.data()};
+        auto label = shape::cpp_type(abtype) + " " + std::to_string(n) + "x" +
+                     std::to_string(n) + "x" + std::to_string(n);
+        print_result("naive " + label,
+                     time_per_iteration(iterations, [&] { naive_gemm(cv, av, bv); }));
+        print_result("gemm " + label,
+                     time_per_iteration(iterations, [&] { gemm(cv, av, bv, 1.0f, 0.0f); }));
+    }
+}
+
+// A small model where most of the time is spent running the instructions instead of computing
+program make_small_mlp(std::size_t layers)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", shape{shape::float_type, {1, 16}});
+    for(std::size_t i = 0; i < layers; i++)
+    {
+        auto w = mm->add_literal(generate_literal(shape{shape::float_type, {16, 16}}, i));
+        auto b = mm->add_literal(generate_literal(shape{shape::float_type, {1, 16}}, i));
+        auto y = mm->add_instruction(make_op("dot"), x, w);
+        y      = mm->add_instruction(make_op("add"), y, b);
+        x      = mm->add_instruction(make_op("relu"), y);
+    }
+    mm->add_return({x});
+    return p;
+}
+
+// Measures the overhead of program::eval on small models
+void bench_eval(std::size_t iterations)
+{
+    for(std::size_t layers : {4, 64})
+    {
+        auto p = make_small_mlp(layers);
+        p.compile(make_target("ref"));
+        parameter_map params;
+        params["x"] = generate_argument(p.get_parameter_shape("x"));
+        auto us     = time_per_iteration(iterations * 100, [&] { p.eval(params); });
+        print_result("eval " + std::to_string(layers) + " layers", us);
+    }
+}
+
+// Eval latency on the ref target, and how many of the host buffers allocated by each eval had to
+// come from the heap instead of the pools
+void bench_host_buffers(std::size_t iterations)
+{
+    const std::vector<std::pair<std::string, std::function<program()>>> models = {
+        {"mlp 64 layers", [] { return make_small_mlp(64); }},
+        {"resnet50", [] { return resnet50(1); }}};
+    for(const auto& [name, make_model] : models)
+    {
+        auto p = make_model();
+        p.compile(make_target("ref"));
+        parameter_map params;
+        for(auto&& [pname, s] : p.get_parameter_shapes())
+            params[pname] = generate_argument(s);
+        // The first eval fills the pools
+        p.eval(params);
+        auto before = get_host_buffer_stats();
+        auto us     = time_per_iteration(iterations, [&] { p.eval(params); });
+        auto after  = get_host_buffer_stats();
+        // Includes the warm up in time_per_iteration
+        auto runs = iterations + 1;
+        print_result("eval " + name, us);
+        std::cout << std::setw(40) << std::left << ("host buffers per eval " + name) << ": "
+                  << (after.allocations - before.allocations) / runs << " allocated, "
+                  << (after.heap_allocations - before.heap_allocations) / runs
+                  << " from the heap" << std::endl;
+    }
+}
+
+// Throughput of one compiled program run from several threads at the same time, each thread with
+// its own execution session. The time is the wall time divided by the total number of runs.
+void bench_sessions(std::size_t iterations)
+{
+    auto p = make_small_mlp(64);
+    p.compile(make_target("ref"));
+    parameter_map params;
+    params["x"]            = generate_argument(p.get_parameter_shape("x"));
+    const std::size_t runs = iterations * 100;
+    for(std::size_t nthreads : {1, 2, 4, 8})
+    {
+        std::vector<execution_session> sessions;
+        for(std::size_t i = 0; i < nthreads; i++)
+            sessions.emplace_back(p);
+        auto us = time<std::chrono::duration<double, std::micro>>([&] {
+            std::vector<std::thread> threads;
+            for(const auto& session : sessions)
+            {
+                threads.emplace_back([&] {
+                    for(std::size_t i = 0; i < runs; i++)
+                        session.eval(params);
+                });
+            }
+            for(auto& t : threads)
+                t.join();
+        });
+        print_result("sessions " + std::to_string(nthreads) + " threads", us / (runs * nthreads));
+    }
+}
+
+// A model with a dynamic batch, where each layer adds a broadcasted bias
+program make_dynamic_batch_program(std::size_t layers, std::size_t max_batch)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", shape{shape::float_type, {{1, max_batch}, {64, 64}}});
+    for(std::size_t i = 0; i < layers; i++)
+    {
+        auto b  = mm->add_literal(generate_literal(shape{shape::float_type, {64}}, i));
+        auto bb = mm->add_instruction(make_op("multibroadcast"), b, x);
+        x       = mm->add_instruction(make_op("add"), x, bb);
+        x       = mm->add_instruction(make_op("relu"), x);
+    }
+    mm->add_return({x});
+    return p;
+}
+
+// Compares splitting a dynamic batch into a submodule for every batch size when compiling against
+// compiling a specialization for each batch size the first time it is run
+void bench_specializations(std::size_t iterations)
+{
+    const std::size_t max_batch = 256;
+    auto dynamic                = make_dynamic_batch_program(16, max_batch);
+    print_result("split_single_dyn_dim compile", time_per_iteration(iterations, [&] {
+                     auto p = dynamic;
+                     run_passes(p, {split_single_dyn_dim{}, dead_code_elimination{}});
+                     p.compile(make_target("ref"));
+                 }));
+    const std::vector<std::size_t> batches = {1, 8, 64, 1, 8, 64, 256, 1};
+    std::vector<parameter_map> params(batches.size());
+    std::transform(batches.begin(), batches.end(), params.begin(), [](std::size_t batch) {
+        return parameter_map{
+            {"x", generate_argument(shape{shape::float_type, {batch, 64}}, batch)}};
+    });
+    specialization_stats stats;
+    print_result("specializations first runs", time_per_iteration(iterations, [&] {
+                     auto p = dynamic;
+                     compile_options options;
+                     options.max_specializations = 4;
+                     p.compile(make_target("ref"), options);
+                     for(const auto& pm : params)
+                         p.eval(pm);
+                     stats = p.get_specialization_stats();
+                 }));
+    std::cout << "Specializations hits: " << stats.hits << ", misses: " << stats.misses
+              << ", evictions: " << stats.evictions << ", compile: " << stats.compile_ms
+              << "ms, longest compile: " << stats.max_compile_ms << "ms" << std::endl;
+}
+
+// Compares the blocked reference gemm against per element evaluation, with a transposed B
+void bench_gemm(std::size_t iterations)
+{
+    bench_gemm_type<float, float>(iterations, shape::float_type, shape::float_type);
+    bench_gemm_type<std::int32_t, std::int8_t>(iterations, shape::int32_type, shape::int8_type);
+}
+
+// Returns a field of /proc/self/status in kB, or 0 when it is not available
+std::size_t read_proc_status(const std::string& field)
+{
+    std::ifstream is("/proc/self/status");
+    std::string line;
+    while(std::getline(is, line))
+    {
+        if(starts_with(line, field + ":"))
+            return std::stoul(line.substr(field.size() + 1));
+    }
+    return 0;
+}
+
+// Peak resident memory growth in MB while running f
+template <class F>
+double peak_rss_increase(F f)
+{
+    // Resets the peak resident set size of the process
+    std::ofstream("/proc/self/clear_refs") << "5";
+    auto before = read_proc_status("VmRSS");
+    f();
+    auto peak = read_proc_status("VmHWM");
+    return (peak > before ? peak - before : 0) / 1024.0;
+}
+
+// A program with 256MB of literals
+program make_weights_program()
+{
+    program p;
+    auto* mm = p.get_main_module();
+    shape s{shape::float_type, {1024, 2048}};
+    auto x = mm->add_parameter("x", s);
+    for(std::size_t i = 0; i < 32; i++)
+    {
+        auto l = mm->add_literal(literal{s, std::vector<float>(s.elements(), i)});
+        x      = mm->add_instruction(make_op("add"), x, l);
+    }
+    mm->add_return({x});
+    return p;
+}
+
+void print_mb(const std::string& name, double mb)
+{
+    std::cout << std::setw(40) << std::left << name << ": " << mb << "MB" << std::endl;
+}
+
+// Compares loading a memory mapped file against reading and decoding a plain msgpack file
+void bench_load(std::size_t iterations)
+{
+    tmp_dir td{"bench_load"};
+    auto mapped_file = (td.path / "mapped.mxr").string();
+    auto plain_file  = (td.path / "plain.mxr").string();
+    {
+        auto p = make_weights_program();
+        save(p, mapped_file);
+        write_buffer(plain_file, to_msgpack(p.to_value()));
+    }
+    for(const auto& file : {plain_file, mapped_file})
+    {
+        auto name = fs::path{file}.stem().string();
+        auto mb   = peak_rss_increase([&] { load(file); });
+        print_result("load " + name, time_per_iteration(iterations, [&] { load(file); }));
+        print_mb("peak rss " + name, mb);
+    }
+}
+
+// Just enough of the protobuf wire format to write an onnx model without linking the onnx schema
+void write_varint(std::string& out, std::uint64_t x)
+{
+    do
+    {
+        char b = x & 0x7f;
+        x >>= 7;
+        if(x != 0)
+            b |= 0x80; // NOLINT
+        out.push_back(b);
+    } while(x != 0);
+}
+
+void write_field(std::string& out, std::uint64_t field, std::uint64_t x)
+{
+    write_varint(out, field << 3u);
+    write_varint(out, x);
+}
+
+void write_field(std::string& out, std::uint64_t field, const std::string& s)
+{
+    write_varint(out, (field << 3u) | 2u);
+    write_varint(out, s.size());
+    out += s;
+}
+
+// An onnx model that returns n float initializers of shape s, stored one after another in
+// data_file starting at offset
+std::string make_external_data_model(std::size_t n,
+                                     const shape& s,
+                                     const std::string& data_file,
+                                     std::size_t offset)
+{
+    auto entry = [](const std::string& key, const std::string& value) {
+        std::string e;
+        write_field(e, 1, key);
+        write_field(e, 2, value);
+        return e;
+    };
+    std::string graph;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto name = "w" + std::to_string(i);
+        std::string tensor;
+        for(auto d : s.lens())
+            write_field(tensor, 1, d);
+        write_field(tensor, 2, 1); // FLOAT
+        write_field(tensor, 8, name);
+        write_field(tensor, 13, entry("location", data_file));
+        write_field(tensor, 13, entry("offset", std::to_string(offset + i * s.bytes())));
+        write_field(tensor, 13, entry("length", std::to_string(s.bytes())));
+        write_field(tensor, 14, 1); // EXTERNAL
+        write_field(graph, 5, tensor);
+        std::string output;
+        write_field(output, 1, name);
+        write_field(graph, 12, output);
+    }
+    std::string opset;
+    write_field(opset, 2, 13);
+    std::string model;
+    write_field(model, 1, 8);
+    write_field(model, 7, graph);
+    write_field(model, 8, opset);
+    return model;
+}
+
+// Compares parsing an onnx model whose external data is aligned, so the literals use the mapped
+// file directly, against one with unaligned offsets where every tensor is copied
+void bench_onnx_external_data(std::size_t iterations)
+{
+    tmp_dir td{"bench_onnx_external_data"};
+    const std::size_t n = 32;
+    shape s{shape::float_type, {1024, 2048}};
+    for(std::size_t offset : {0, 1})
+    {
+        auto name      = offset == 0 ? std::string{"aligned"} : std::string{"unaligned"};
+        auto data_file = name + ".weight";
+        auto onnx_file = (td.path / (name + ".onnx")).string();
+        write_buffer(td.path / data_file, std::vector<char>(offset + n * s.bytes(), 1));
+        auto model = make_external_data_model(n, s, data_file, offset);
+        write_buffer(onnx_file, model.data(), model.size());
+        auto mb = peak_rss_increase([&] { parse_onnx(onnx_file); });
+        print_result("parse_onnx " + name, time_per_iteration(iterations, [&] {
+                         parse_onnx(onnx_file);
+                     }));
+        print_mb("peak rss " + name, mb);
+    }
+}
+
+// A program with many if branches that each have redundant and dead code
+program make_branching_program(std::size_t nbranches, std::size_t n)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    shape s{shape::float_type, {64}};
+    auto cond = mm->add_parameter("cond", shape{shape::bool_type, {1}});
+    auto make_branch = [&](const std::string& name) {
+        auto* sm = p.create_module(name);
+        auto x   = sm->add_literal(generate_literal(s, n));
+        for(std::size_t i = 0; i < n; i++)
+        {
+            auto y = sm->add_instruction(make_op("add"), x, x);
+            sm->add_instruction(make_op("mul"), x, x);
+            auto z = sm->add_instruction(make_op("add"), x, x);
+            x      = sm->add_instruction(make_op("sub"), y, z);
+        }
+        sm->add_return({x});
+        return sm;
+    };
+    std::vector<instruction_ref> outputs;
+    for(std::size_t i = 0; i < nbranches; i++)
+    {
+        auto* then_mod = make_branch("then" + std::to_string(i));
+        auto* else_mod = make_branch("else" + std::to_string(i));
+        auto r         = mm->add_instruction(make_op("if"), {cond}, {then_mod, else_mod});
+        outputs.push_back(mm->add_instruction(make_op("get_tuple_elem", {{"index", 0}}), r));
+    }
+    mm->add_return(outputs);
+    return p;
+}
+
+// Compares running the passes on the whole program, where the independent submodules are
+// processed concurrently, against running them one module at a time
+void bench_run_passes(std::size_t iterations)
+{
+    const std::vector<pass> passes = {eliminate_common_subexpression{}, dead_code_elimination{}};
+    auto p                         = make_branching_program(64, 100);
+    double us                      = 0;
+    for(std::size_t i = 0; i < iterations; i++)
+    {
+        auto q = p;
+        us += time<std::chrono::duration<double, std::micro>>([&] { run_passes(q, passes); });
+    }
+    print_result("run_passes program", us / iterations);
+    us = 0;
+    for(std::size_t i = 0; i < iterations; i++)
+    {
+        auto q    = p;
+        auto mods = q.get_modules();
+        us += time<std::chrono::duration<double, std::micro>>([&] {
+            for(auto* mod : reverse(mods))
+                run_passes(*mod, passes);
+        });
+    }
+    print_result("run_passes each module", us / iterations);
+}
+
+// Compares running a fused pointwise submodule over blocks of elements against evaluating it
+// once for each element
+void bench_pointwise(std::size_t iterations)
+{
+    auto make_pointwise = [](module& m) {
+        auto x   = m.add_parameter("x0", shape{shape::float_type});
+        auto y   = m.add_parameter("x1", shape{shape::float_type});
+        auto one = m.add_literal(1.0f);
+        auto mul = m.add_instruction(make_op("mul"), x, y);
+        auto add = m.add_instruction(make_op("add"), mul, one);
+        m.add_instruction(make_op("relu"), add);
+    };
+    program p;
+    auto* pm = p.create_module("pointwise");
+    make_pointwise(*pm);
+    // Used to evaluate the submodule for each element
+    program sub;
+    make_pointwise(*sub.get_main_module());
+    sub.compile(make_target("ref"));
+    auto run = [&](module_ref&, const std::unordered_map<std::string, argument>& params) {
+        return sub.eval(params);
+    };
+    auto pnames = pm->get_parameter_names();
+    std::sort(pnames.begin(), pnames.end());
+    for(std::size_t n : {4096, 262144})
+    {
+        shape s{shape::float_type, {n}};
+        std::vector<argument> args = {generate_argument(s, 0), generate_argument(s, 1)};
+        op::pointwise op;
+        print_result("pointwise elements " + std::to_string(n),
+                     time_per_iteration(
+                         iterations, [&] { op.compute_elements(s, args, pm, pnames, run); }));
+        print_result("pointwise blocks " + std::to_string(n),
+                     time_per_iteration(iterations, [&] { op.compute(s, args, {pm}, run); }));
+    }
+}
+
+// Peak memory while evaluating a model bundled with the driver on the ref target. Each model is a
+// separate benchmark since the memory freed after the first model stays with the process.
+void bench_eval_memory(const std::string& name, const std::function<program(unsigned)>& make_model)
+{
+    auto p = make_model(1);
+    p.compile(make_target("ref"));
+    parameter_map params;
+    for(auto&& [pname, s] : p.get_parameter_shapes())
+        params[pname] = generate_argument(s);
+    print_mb("eval peak rss " + name, peak_rss_increase([&] { p.eval(params); }));
+}
+
+// Compares streaming the program to a file against serializing the whole program value to a
+// plain msgpack buffer first
+void bench_save(std::size_t iterations)
+{
+    tmp_dir td{"bench_save"};
+    auto file        = (td.path / "program.mxr").string();
+    auto p           = make_weights_program();
+    auto save_plain  = [&] { write_buffer(file, to_msgpack(p.to_value())); };
+    auto save_mapped = [&] { save(p, file); };
+    print_mb("peak rss plain", peak_rss_increase(save_plain));
+    print_mb("peak rss mapped", peak_rss_increase(save_mapped));
+    print_result("save plain", time_per_iteration(iterations, save_plain));
+    print_result("save mapped", time_per_iteration(iterations, save_mapped));
+}
+
+// A chain of layers that each write to a new allocation and also read the outputs of the two
+// previous layers and of the layer at the start of the block, like the residuals in a transformer
+module make_allocation_chain(std::size_t n)
+{
+    module m;
+    std::vector<instruction_ref> outputs;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        shape s{shape::float_type, {1, 128, 64 * (1 + i % 12)}};
+        auto alloc = m.add_instruction(make_op("allocate", {{"shape", to_value(s)}}));
+        std::vector<instruction_ref> args = {alloc};
+        if(outputs.size() > 0)
+            args.push_back(outputs[outputs.size() - 1]);
+        if(outputs.size() > 1)
+            args.push_back(outputs[outputs.size() - 2]);
+        if(i % 12 != 0)
+            args.push_back(outputs[i - i % 12]);
+        outputs.push_back(m.add_instruction(make_op("identity"), args));
+    }
+    return m;
+}
+
+// Compares planning the scratch memory with graph coloring against the interval planner
+void bench_memory_coloring(std::size_t iterations)
+{
+    for(std::size_t n : {1000, 4000})
+    {
+        auto m = make_allocation_chain(n);
+        for(bool intervals : {false, true})
+        {
+            std::string name = std::string{intervals ? "intervals " : "coloring "} +
+                               std::to_string(n) + " allocations";
+            module r;
+            double us = 0;
+            for(std::size_t i = 0; i < iterations; i++)
+            {
+                r = m;
+                us += time<std::chrono::duration<double, std::micro>>(
+                    [&] { memory_coloring{"allocate", false, intervals}.apply(r); });
+            }
+            print_result(name, us / iterations);
+            print_mb(name + " scratch", r.get_parameter_shape("scratch").bytes() / 1048576.0);
+        }
+    }
+}
+
+// Time to fold the constants in the models bundled with the driver
+void bench_propagate_constant(std::size_t iterations)
+{
+    const std::vector<std::pair<std::string, std::function<program(unsigned)>>> models = {
+        {"resnet50", &resnet50}, {"inceptionv3", &inceptionv3}};
+    for(const auto& [name, make_model] : models)
+    {
+        auto p    = make_model(1);
+        double us = 0;
+        for(std::size_t i = 0; i < iterations; i++)
+        {
+            auto q = p;
+            us += time<std::chrono::duration<double, std::micro>>([&] {
+                run_passes(*q.get_main_module(), {propagate_constant{}, dead_code_elimination{}});
+            });
+        }
+        print_result("propagate_constant " + name, us / iterations);
+    }
+}
+
+// A module of n instructions where every layer is computed twice, using only a few distinct
+// operators so that most instructions share the same name
+module make_redundant_module(std::size_t n)
+{
+    module m;
+    shape s{shape::float_type, {16}};
+    auto x = m.add_parameter("x", s);
+    auto y = m.add_parameter("y", s);
+    const std::vector<std::string> ops = {"add", "mul", "sub"};
+    for(std::size_t i = 0; i < n / 4; i++)
+    {
+        const auto& name = ops[i % ops.size()];
+        auto x1          = m.add_instruction(make_op(name), x, y);
+        auto x2          = m.add_instruction(make_op(name), x, y);
+        x                = m.add_instruction(make_op("add"), x1, x2);
+        y                = m.add_instruction(make_op(name), y, x);
+    }
+    m.add_return({x, y});
+    return m;
+}
+
+// Time for common subexpression elimination on large synthetic modules
+void bench_cse(std::size_t iterations)
+{
+    for(std::size_t n : {10000, 100000})
+    {
+        auto m    = make_redundant_module(n);
+        double us = 0;
+        for(std::size_t i = 0; i < iterations; i++)
+        {
+            module r = m;
+            us += time<std::chrono::duration<double, std::micro>>(
+                [&] { eliminate_common_subexpression{}.apply(r); });
+        }
+        print_result("cse " + std::to_string(n) + " instructions", us / iterations);
+    }
+}
+
+// A deep chain of blocks that square their input and add it back, like the variance in a
+// layernorm, so every block joins two paths that both depend on all the previous blocks
+module make_square_chain_module(std::size_t n)
+{
+    module m;
+    auto x = m.add_parameter("x", shape{shape::float_type, {64}});
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto sq = m.add_instruction(make_op("mul"), x, x);
+        x       = m.add_instruction(make_op("add"), x, sq);
+    }
+    return m;
+}
+
+void bench_dominator(std::size_t iterations)
+{
+    for(std::size_t n : {1000, 5000})
+    {
+        auto m = make_square_chain_module(n);
+        print_result("compute_dominator " + std::to_string(n) + " blocks",
+                     time_per_iteration(iterations, [&] { compute_dominator(m); }));
+    }
+}
+
+// Time to optimize and compile a whole program on the ref target, which is dominated by the
+// module bookkeeping on large graphs
+void bench_compile(std::size_t iterations)
+{
+    const std::vector<std::pair<std::string, std::function<program()>>> models = {
+        {"resnet50", [] { return resnet50(1); }},
+        {"inceptionv3", [] { return inceptionv3(1); }},
+        {"mlp 2000 layers", [] { return make_small_mlp(2000); }}};
+    for(const auto& [name, make_model] : models)
+    {
+        auto p    = make_model();
+        double us = 0;
+        for(std::size_t i = 0; i < iterations; i++)
+        {
+            auto q = p;
+            us += time<std::chrono::duration<double, std::micro>>([&] {
+                run_passes(q, {normalize_ops{}, optimize_module{}});
+                q.compile(make_target("ref"));
+            });
+        }
+        print_result("compile " + name, us / iterations);
+    }
+}
+
+// Evaluates a single operator on the ref target, integer inputs are filled with ones so they can
+// be used as indices
+double time_ref_op(std::size_t iterations, const operation& op, const std::vector<shape>& inputs)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    std::vector<instruction_ref> params;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+        params.push_back(mm->add_parameter("x" + std::to_string(i), inputs[i]));
+    mm->add_instruction(op, params);
+    p.compile(make_target("ref"));
+    parameter_map m;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        m[name] = shape::is_integral(s.type()) ? fill_argument(s, 1) : generate_argument(s);
+    return time_per_iteration(iterations, [&] { p.eval(m); });
+}
+
+// Strided kernels of the ref ops, compared against finding every element from its multi-index
+// with shape::multi and shape::index like the ops did before they used shape_runs
+void bench_strided(std::size_t iterations)
+{
+    auto transposed = shape::from_permutation(shape::float_type, {8, 64, 56, 56}, {0, 2, 3, 1});
+    auto input = generate_argument(transposed);
+    print_result("contiguous", time_ref_op(iterations, make_op("contiguous"), {transposed}));
+    print_result("contiguous multi-index", time_per_iteration(iterations, [&] {
+                     shape out_shape{shape::float_type, transposed.lens()};
+                     argument result{out_shape};
+                     visit_all(result, input)([&](auto output, auto x) {
+                         for(std::size_t i = 0; i < out_shape.elements(); i++)
+                         {
+                             auto idx  = out_shape.multi(i);
+                             output[i] = x(idx.begin(), idx.end());
+                         }
+                     });
+                 }));
+
+    shape reduce_input{shape::float_type, {8, 64, 56, 56}};
+    auto reduce_arg = generate_argument(reduce_input);
+    for(const std::vector<int64_t>& axes : {std::vector<int64_t>{1}, std::vector<int64_t>{2, 3}})
+    {
+        auto name = "reduce_sum " + to_string_range(axes);
+        auto op   = make_op("reduce_sum", {{"axes", axes}});
+        print_result(name, time_ref_op(iterations, op, {reduce_input}));
+        auto out_shape = compute_shape(op, {reduce_input});
+        std::vector<std::size_t> batch_lens(out_shape.ndim(), 1);
+        for(auto axis : axes)
+            batch_lens[axis] = reduce_input.lens()[axis];
+        shape batch_shape{shape::float_type, batch_lens};
+        print_result(name + " multi-index", time_per_iteration(iterations, [&] {
+                         argument result{out_shape};
+                         visit_all(result, reduce_arg)([&](auto output, auto x) {
+                             par_for(out_shape.elements(), [&](auto i) {
+                                 auto out_idx  = out_shape.multi(i);
+                                 auto data_idx = out_idx;
+                                 double sum    = 0;
+                                 shape_for_each(batch_shape, [&](const auto& b_idx) {
+                                     for(auto axis : axes)
+                                         data_idx[axis] = b_idx[axis];
+                                     sum += x(data_idx.begin(), data_idx.end());
+                                 });
+                                 output[i] = sum;
+                             });
+                         });
+                     }));
+    }
+
+    print_result("gather",
+                 time_ref_op(iterations,
+                             make_op("gather", {{"axis", 1}}),
+                             {shape{shape::float_type, {64, 1000, 64}},
+                              shape{shape::int32_type, {256}}}));
+    print_result("convolution",
+                 time_ref_op(iterations,
+                             make_op("convolution", {{"padding", {1, 1}}}),
+                             {shape{shape::float_type, {1, 64, 56, 56}},
+                              shape{shape::float_type, {64, 64, 3, 3}}}));
+    print_result("pooling",
+                 time_ref_op(iterations,
+                             make_op("pooling",
+                                     {{"mode", op::pooling_mode::max},
+                                      {"lengths", {3, 3}},
+                                      {"stride", {2, 2}},
+                                      {"padding", {1, 1}}}),
+                             {shape{shape::float_type, {8, 64, 112, 112}}}));
+}
+
+const std::map<std::string, benchmark_function>& get_benchmarks()
+{
+    static const std::map<std::string, benchmark_function> m = {
+        {"compile", &bench_compile},
+        {"cse", &bench_cse},
+        {"dominator", &bench_dominator},
+        {"eval", &bench_eval},
+        {"eval_memory_inceptionv3",
+         [](std::size_t) { bench_eval_memory("inceptionv3", &inceptionv3); }},
+        {"eval_memory_resnet50", [](std::size_t) { bench_eval_memory("resnet50", &resnet50); }},
+        {"gemm", &bench_gemm},
+        {"host_buffers", &bench_host_buffers},
+        {"load", &bench_load},
+        {"memory_coloring", &bench_memory_coloring},
+        {"onnx_external_data", &bench_onnx_external_data},
+        {"par_for", &bench_par_for},
+        {"pointwise", &bench_pointwise},
+        {"propagate_constant", &bench_propagate_constant},
+        {"run_passes", &bench_run_passes},
+        {"save", &bench_save},
+        {"sessions", &bench_sessions},
+        {"specializations", &bench_specializations},
+        {"strided", &bench_strided},
+    };
+    return m;
+}
+
+std::vector<std::string> get_benchmark_names()
+{
+    std::vector<std::string> result;
+    std::transform(get_benchmarks().begin(),
+                   get_benchmarks().end(),
+                   std::back_inserter(result),
+                   [](auto&& p) { return p.first; });
+    return result;
+}
+
+void run_benchmark(const std::string& name, std::size_t iterations)
+{
+    if(not contains(get_benchmarks(), name))
+        MIGRAPHX_THROW("Unknown benchmark: " + name);
+    std::cout << "Benchmark " << name << ": " << iterations << " iterations" << std::endl;
+    get_benchmarks().at(name)(iterations);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
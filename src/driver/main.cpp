@@ -29,6 +29,7 @@
 #include "precision.hpp"
 #include "passes.hpp"
 #include "perf.hpp"
+#include "bench.hpp"
 #include "models.hpp"
 #include "marker_roctx.hpp"
 
@@ -48,6 +49,7 @@
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/register_op.hpp>
@@ -385,18 +387,13 @@ struct loader
         return p;
     }
 
-    static void write(std::ostream& os, const std::vector<char>& buffer)
-    {
-        os.write(buffer.data(), buffer.size());
-    }
-
     void save(const program& p) const
     {
         auto* os = &std::cout;
         std::ofstream fs;
         if(not output.empty())
         {
-            fs.open(output);
+            fs.open(output, std::ios::out | std::ios::binary);
             os = &fs;
         }
 
@@ -420,7 +417,7 @@ struct loader
         else if(type == "json")
             *os << to_json_string(p.to_value()) << std::endl;
         else if(type == "binary")
-            write(*os, save_buffer(p));
+            migraphx::save(p, *os);
     }
 };
 
@@ -484,9 +481,11 @@ struct compiler
     program_params parameters;
     compiler_target ct;
     compile_options co;
-    bool to_fp16 = false;
-    bool to_fp8  = false;
-    bool to_int8 = false;
+    bool to_fp16        = false;
+    bool to_fp8         = false;
+    bool to_int8        = false;
+    bool profile_passes = false;
+    std::string profile_passes_json;
 
     std::vector<std::string> fill0;
     std::vector<std::string> fill1;
@@ -507,9 +506,20 @@ struct compiler
            {"--exhaustive-tune"},
            ap.help("Exhastively search for best tuning parameters for kernels"),
            ap.set_value(true));
+        ap(co.max_specializations,
+           {"--max-specializations"},
+           ap.help("Compile a program with dynamic input shapes for each set of input shapes when "
+                   "it is run, keeping at most this many compiled specializations"));
         ap(to_fp16, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(true));
         ap(to_int8, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(true));
         ap(to_fp8, {"--fp8"}, ap.help("Quantize for fp8e4m3fnuz type"), ap.set_value(true));
+        ap(profile_passes,
+           {"--profile-passes"},
+           ap.help("Print the time spent in each compile pass"),
+           ap.set_value(true));
+        ap(profile_passes_json,
+           {"--profile-passes-json"},
+           ap.help("Write the time and instruction counts of each compile pass to a json file"));
     }
 
     auto params(const program& p)
@@ -564,7 +574,16 @@ struct compiler
         {
             quantize_fp8(p, t, {host_params(p)});
         }
+        if(profile_passes or not profile_passes_json.empty())
+            co.profile = std::make_shared<pass_profile>();
         p.compile(t, co);
+        if(profile_passes)
+            co.profile->print_summary(std::cout);
+        if(not profile_passes_json.empty())
+        {
+            std::ofstream os(profile_passes_json);
+            os << to_pretty_json_string(co.profile->to_value()) << std::endl;
+        }
         l.save(p);
         return p;
     }
@@ -603,6 +622,8 @@ struct verify : command<verify>
     std::optional<double> rtol;
     bool per_instruction = false;
     bool reduce          = false;
+    bool capture         = false;
+    bool bisect          = false;
     verify_options vo;
     void parse(argument_parser& ap)
     {
@@ -615,6 +636,14 @@ struct verify : command<verify>
            ap.help("Verify each instruction"),
            ap.set_value(true));
         ap(reduce, {"-r", "--reduce"}, ap.help("Reduce program and verify"), ap.set_value(true));
+        ap(capture,
+           {"--capture"},
+           ap.help("Run the program once and verify the output of every instruction"),
+           ap.set_value(true));
+        ap(bisect,
+           {"--bisect"},
+           ap.help("Find the first divergent instruction by bisecting the reduced programs"),
+           ap.set_value(true));
         ap(vo.ref_use_double,
            {"--ref-use-double"},
            ap.help("Convert floating point values to double on ref"),
@@ -652,6 +681,14 @@ struct verify : command<verify>
         {
             verify_reduced_program(p, t, c.co, vo, m, tols);
         }
+        else if(capture)
+        {
+            verify_captured_program(p, t, c.co, vo, m, tols);
+        }
+        else if(bisect)
+        {
+            verify_bisect_program(p, t, c.co, vo, m, tols);
+        }
         else
         {
             verify_program(c.l.file, p, t, c.co, vo, m, tols);
@@ -713,6 +750,30 @@ struct perf : command<perf>
     }
 };
 
+struct bench : command<bench>
+{
+    std::string name;
+    unsigned n     = 1000;
+    bool show_list = false;
+    void parse(argument_parser& ap)
+    {
+        ap(name, {}, ap.metavar("<benchmark name>"));
+        ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to run"));
+        ap(show_list, {"--list", "-l"}, ap.help("List all the benchmarks"), ap.set_value(true));
+    }
+
+    void run() const
+    {
+        if(show_list or name.empty())
+        {
+            for(const auto& b : get_benchmark_names())
+                std::cout << b << std::endl;
+            return;
+        }
+        run_benchmark(name, n);
+    }
+};
+
 struct roctx : command<roctx>
 {
     compiler c;
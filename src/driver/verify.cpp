@@ -32,6 +32,7 @@
 #include <migraphx/quantization.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/fp_to_double.hpp>
+#include <migraphx/iterator_for.hpp>
 
 namespace migraphx {
 namespace driver {
@@ -115,7 +116,7 @@ std::vector<argument> run_target(program p,
     return output;
 }
 
-void verify_program(const std::string& name,
+bool verify_program(const std::string& name,
                     const program& p,
                     const target& t,
                     compile_options options,
@@ -136,6 +137,7 @@ void verify_program(const std::string& name,
             std::cout << "FAILED: " << name << std::endl;
             std::cout << "Shape mismatch {" << ref_outs[i].get_shape() << "} != {"
                       << target_outs[i].get_shape() << "}" << std::endl;
+            passed = false;
         }
         else
         {
@@ -144,6 +146,7 @@ void verify_program(const std::string& name,
     }
     if(passed)
         std::cout << "MIGraphX verification passed successfully." << std::endl;
+    return passed;
 }
 
 void verify_instructions(const program& prog,
@@ -191,7 +194,7 @@ void verify_instructions(const program& prog,
     }
 }
 
-void verify_reduced(program p,
+bool verify_reduced(program p,
                     int n,
                     const target& t,
                     compile_options options,
@@ -206,13 +209,14 @@ void verify_reduced(program p,
     std::cout << p << std::endl;
     try
     {
-        verify_program(std::to_string(n), p, t, options, vo, inputs, tols);
+        return verify_program(std::to_string(n), p, t, options, vo, inputs, tols);
     }
     catch(const std::exception& e)
     {
         std::cout << "FAILED: " << n << std::endl;
         std::cout << "Exception: " << e.what() << std::endl;
     }
+    return false;
 }
 
 void verify_reduced_program(const program& p,
@@ -237,6 +241,152 @@ void verify_reduced_program(const program& p,
     }
 }
 
+// The instructions whose outputs are compared when the intermediates are captured. Instructions
+// that only alias their input are skipped since their data is captured with the input.
+std::vector<instruction_ref> get_captured_instructions(module& m)
+{
+    std::vector<instruction_ref> result;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name().front() == '@' or ins->name() == "undefined")
+            continue;
+        if(ins->get_shape().type() == shape::tuple_type)
+            continue;
+        if(instruction::get_output_alias(ins, true) != ins)
+            continue;
+        result.push_back(ins);
+    }
+    return result;
+}
+
+// Converts to a standard double argument, so outputs with different layouts or types can be
+// compared
+argument to_double_argument(const argument& arg)
+{
+    argument result{shape{shape::double_type, arg.get_shape().lens()}};
+    auto output = result.get<double>();
+    arg.visit([&](auto input) {
+        std::transform(input.begin(), input.end(), output.begin(), [](auto x) {
+            return static_cast<double>(x);
+        });
+    });
+    return result;
+}
+
+instruction_ref verify_captured_program(const program& p,
+                                        const target& t,
+                                        compile_options options,
+                                        verify_options vo,
+                                        const parameter_map& inputs,
+                                        verify::tolerance tols)
+{
+    // Every captured instruction is added as an output so both targets run the program only once
+    program cp   = p;
+    auto* mm     = cp.get_main_module();
+    auto outputs = mm->get_returns();
+    auto nout    = outputs.size();
+    auto captured = get_captured_instructions(*mm);
+    outputs.insert(outputs.end(), captured.begin(), captured.end());
+    mm->replace_return(outputs);
+    std::cout << "Captured instructions: " << captured.size() << std::endl;
+
+    auto ref_outs    = run_ref(cp, options, vo, inputs);
+    auto target_outs = run_target(cp, t, options, vo, inputs);
+
+    std::vector<bool> diverged(captured.size());
+    for(std::size_t i = 0; i < captured.size(); i++)
+    {
+        const auto& ref_out    = ref_outs[nout + i];
+        const auto& target_out = target_outs[nout + i];
+        if(ref_out.get_shape().lens() != target_out.get_shape().lens())
+        {
+            diverged[i] = true;
+            continue;
+        }
+        auto ref_data    = to_double_argument(ref_out);
+        auto target_data = to_double_argument(target_out);
+        diverged[i]      = not verify::verify_range_with_tolerance(
+            target_data.get<double>(), verify::expected{ref_data.get<double>()}, tols);
+    }
+    auto first = std::find(diverged.begin(), diverged.end(), true);
+    std::cout << "Diverged instructions: " << std::count(diverged.begin(), diverged.end(), true)
+              << "/" << captured.size() << std::endl;
+    const auto* pmm = p.get_main_module();
+    if(first == diverged.end())
+    {
+        std::cout << "MIGraphX verification passed successfully." << std::endl;
+        return pmm->end();
+    }
+    auto i   = std::distance(diverged.begin(), first);
+    auto ins = captured[i];
+    std::cout << "First divergent instruction: " << std::endl;
+    mm->debug_print(ins);
+    // The copied program has the same instructions in the same order
+    auto result = std::next(pmm->begin(), std::distance(mm->begin(), ins));
+    for(auto input : ins->inputs())
+    {
+        auto it = std::find(captured.begin(), captured.end(), instruction::get_output_alias(input));
+        if(it == captured.end())
+            continue;
+        std::cout << "Input " << input->name() << " matches: " << std::boolalpha
+                  << not diverged[std::distance(captured.begin(), it)] << std::endl;
+    }
+    const auto& ref_out    = ref_outs[nout + i];
+    const auto& target_out = target_outs[nout + i];
+    if(ref_out.get_shape().lens() != target_out.get_shape().lens())
+    {
+        std::cout << "Shape mismatch {" << ref_out.get_shape() << "} != {"
+                  << target_out.get_shape() << "}" << std::endl;
+        return result;
+    }
+    verify_args(ins->name(),
+                to_double_argument(target_out),
+                verify::expected{to_double_argument(ref_out)},
+                tols);
+    return result;
+}
+
+instruction_ref verify_bisect_program(const program& p,
+                                      const target& t,
+                                      compile_options options,
+                                      verify_options vo,
+                                      const parameter_map& inputs,
+                                      verify::tolerance tols)
+{
+    const auto* mm = p.get_main_module();
+    auto n         = mm->size();
+    // Positions of the instructions the program can be truncated after
+    std::vector<std::size_t> cuts;
+    std::size_t pos = 0;
+    for(auto&& ins : *mm)
+    {
+        if(not contains({"@literal", "@param", "@return"}, ins.name()))
+            cuts.push_back(pos);
+        pos++;
+    }
+    // Binary search for the first truncated program that fails, assuming every program truncated
+    // after it fails too
+    std::size_t first = 0;
+    std::size_t last  = cuts.size();
+    while(first < last)
+    {
+        auto mid = first + (last - first) / 2;
+        if(verify_reduced(p, n - cuts[mid] - 1, t, options, vo, inputs, tols))
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    if(first == cuts.size())
+    {
+        std::cout << "MIGraphX verification passed successfully." << std::endl;
+        return mm->end();
+    }
+    auto result = std::next(mm->begin(), cuts[first]);
+    std::cout << "First divergent instruction: " << std::endl;
+    mm->debug_print(result);
+    return result;
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -27,46 +27,65 @@
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
 
-#include <unordered_set>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+constexpr std::size_t literal_hash_bytes = 64;
+
+// Structural hash of an instruction, which is equal for instructions that compare equal. The
+// inputs are hashed by identity, so equal inputs must already have been merged.
+static std::size_t hash_instruction(instruction_ref ins)
+{
+    std::size_t h = hash_value(ins->name());
+    hash_combine(h, ins->get_operator().to_value().hash());
+    hash_combine(h, ins->get_shape().type());
+    for(auto len : ins->get_shape().lens())
+        hash_combine(h, len);
+    for(auto input : ins->inputs())
+        hash_combine(h, input);
+    for(auto* mod : ins->module_inputs())
+        hash_combine(h, mod);
+    // Only the start of a literal is hashed, so large weights, which may be mapped from a file, are
+    // not read in full. Literals that hash the same are compared with operator==.
+    if(ins->name() == "@literal")
+    {
+        const auto& lit = ins->get_literal();
+        auto n          = std::min<std::size_t>(lit.get_shape().bytes(), literal_hash_bytes);
+        hash_combine(h, std::string_view{lit.data(), n});
+    }
+    return h;
+}
+
+// Instructions are visited in order so the inputs of an instruction have already been replaced
+// by their first equal instruction, which makes a single pass enough to merge whole subgraphs.
 template <class Range>
 void cse_range(module& m, Range&& r)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
-    std::unordered_set<instruction_ref> processed_ins;
+    std::unordered_multimap<std::size_t, instruction_ref> instructions;
     for(auto ins : r)
     {
         // Skip dead instructions
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
-        for(const auto& pp : found_instructions)
+        auto h = hash_instruction(ins);
+        // Find an instruction with the same hash that is equal
+        auto found = range(instructions.equal_range(h));
+        auto it    = std::find_if(found.begin(), found.end(), [&](const auto& pp) {
+            return *pp.second == *ins;
+        });
+        if(it != found.end())
         {
-            auto eq = pp.second;
-            if(contains(processed_ins, eq))
-                continue;
-            if(*eq != *ins)
-                continue;
-            m.replace_instruction(ins, eq);
-            processed_ins.emplace(ins);
-            std::vector<instruction_ref> outputs;
-            std::copy_if(eq->outputs().begin(),
-                         eq->outputs().end(),
-                         std::back_inserter(outputs),
-                         [&](auto x) { return m.has_instruction(x); });
-
-            std::sort(outputs.begin(), outputs.end(), [&](auto x, auto y) {
-                return std::distance(eq, x) < std::distance(eq, y);
-            });
-            cse_range(m, outputs);
+            m.replace_instruction(ins, it->second);
+            continue;
         }
-        instructions.emplace(ins->name(), ins);
+        instructions.emplace(h, ins);
     }
 }
 
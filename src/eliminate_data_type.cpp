@@ -27,10 +27,14 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <iostream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_ELIMINATE_DATA_TYPE)
+
 void insert_convert_to_supported_type(module& m,
                                       instruction_ref ins,
                                       migraphx::shape::type_t target_type,
@@ -54,6 +58,11 @@ void insert_convert_to_supported_type(module& m,
     // if no change
     if(inputs == ins->inputs())
         return;
+    if(enabled(MIGRAPHX_TRACE_ELIMINATE_DATA_TYPE{}))
+    {
+        std::cout << "eliminate_data_type: convert to " << shape::cpp_type(target_type) << ": ";
+        m.debug_print(ins);
+    }
     auto op         = ins->get_operator();
     auto attributes = op.attributes();
     if(attributes.contains("general_data_type"))
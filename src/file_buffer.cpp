@@ -24,9 +24,17 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/errors.hpp>
 #include <migraphx/fileutils.hpp>
+#include <migraphx/make_shared_array.hpp>
 #include <fstream>
 #include <iostream>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
@@ -65,6 +73,38 @@ std::string read_string(const fs::path& filename)
     return generic_read_file<std::string>(filename);
 }
 
+std::pair<std::shared_ptr<char>, std::size_t> map_buffer(const fs::path& filename)
+{
+#ifdef _WIN32
+    auto buffer = read_buffer(filename);
+    auto size   = buffer.size();
+    return {make_shared_array<char>(buffer.begin(), buffer.end()), size};
+#else
+    int fd = open(filename.string().c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Failure opening file: " + filename.string());
+    struct stat st = {};
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Failure reading size of file: " + filename.string());
+    }
+    std::size_t size = st.st_size;
+    if(size < 1)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Invalid size for: " + filename.string());
+    }
+    // A private mapping lets literals be modified in place without touching the file
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(ptr == MAP_FAILED) // NOLINT
+        MIGRAPHX_THROW("Failure mapping file: " + filename.string());
+    return {std::shared_ptr<char>(static_cast<char*>(ptr), [size](char* p) { munmap(p, size); }),
+            size};
+#endif
+}
+
 void write_buffer(const fs::path& filename, const char* buffer, std::size_t size)
 {
     std::ofstream os(filename, std::ios::out | std::ios::binary);
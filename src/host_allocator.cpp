@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_allocator.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_HOST_BUFFER_POOL_SIZE)
+
+// Each power of two is split into this many size classes, so rounding up wastes at most a
+// quarter of the buffer
+static constexpr std::size_t class_steps = 4;
+
+// Larger buffers, such as the weights of a model, are allocated at their size rounded to the
+// alignment and returned to the heap when they are released
+static constexpr std::size_t max_pooled_buffer_size = std::size_t{8} * 1024 * 1024;
+
+static std::size_t floor_log2(std::size_t n)
+{
+    std::size_t result = 0;
+    while(n >>= 1u)
+        result++;
+    return result;
+}
+
+static std::size_t size_class(std::size_t n)
+{
+    if(n <= host_buffer_alignment)
+        return host_buffer_alignment;
+    if(n > max_pooled_buffer_size)
+        return (n + host_buffer_alignment - 1) / host_buffer_alignment * host_buffer_alignment;
+    auto power = std::size_t{1} << floor_log2(n - 1);
+    auto step  = std::max(host_buffer_alignment, power / class_steps);
+    return (n + step - 1) / step * step;
+}
+
+static char* heap_allocate(std::size_t n)
+{
+    return static_cast<char*>(::operator new(n, std::align_val_t{host_buffer_alignment}));
+}
+
+static void heap_deallocate(char* p)
+{
+    ::operator delete(p, std::align_val_t{host_buffer_alignment});
+}
+
+namespace {
+struct host_buffer_pool
+{
+    std::mutex m;
+    std::unordered_map<std::size_t, std::vector<char*>> buffers;
+    std::size_t pooled_bytes = 0;
+    std::size_t max_pooled_bytes =
+        value_of(MIGRAPHX_HOST_BUFFER_POOL_SIZE{}, 64) * std::size_t{1024 * 1024};
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> heap_allocations{0};
+
+    char* allocate(std::size_t size)
+    {
+        allocations++;
+        if(size <= max_pooled_buffer_size)
+        {
+            std::lock_guard<std::mutex> lock(m);
+            auto it = buffers.find(size);
+            if(it != buffers.end() and not it->second.empty())
+            {
+                char* p = it->second.back();
+                it->second.pop_back();
+                pooled_bytes -= size;
+                return p;
+            }
+        }
+        heap_allocations++;
+        return heap_allocate(size);
+    }
+
+    void deallocate(char* p, std::size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if(size <= max_pooled_buffer_size and pooled_bytes + size <= max_pooled_bytes)
+            {
+                buffers[size].push_back(p);
+                pooled_bytes += size;
+                return;
+            }
+        }
+        heap_deallocate(p);
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        for(auto& [size, ps] : buffers)
+        {
+            for(char* p : ps)
+                heap_deallocate(p);
+        }
+        buffers.clear();
+        pooled_bytes = 0;
+    }
+};
+
+struct host_buffer_deleter
+{
+    host_buffer_pool* pool;
+    std::size_t size;
+    void operator()(char* p) const { pool->deallocate(p, size); }
+};
+} // namespace
+
+// The pool is never destroyed, since buffers held by static objects can be released after
+// static destructors run
+static host_buffer_pool& get_pool()
+{
+    static auto* pool = new host_buffer_pool; // NOLINT
+    return *pool;
+}
+
+std::shared_ptr<char> allocate_host_buffer(std::size_t n, bool zero)
+{
+    auto& pool = get_pool();
+    auto size  = size_class(n);
+    char* p    = pool.allocate(size);
+    if(zero)
+        std::memset(p, 0, n);
+    return {p, host_buffer_deleter{&pool, size}};
+}
+
+void release_host_buffers() { get_pool().release(); }
+
+host_buffer_stats get_host_buffer_stats()
+{
+    auto& pool = get_pool();
+    host_buffer_stats result;
+    result.allocations      = pool.allocations;
+    result.heap_allocations = pool.heap_allocations;
+    std::lock_guard<std::mutex> lock(pool.m);
+    result.pooled_bytes = pool.pooled_bytes;
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,126 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_ARENA_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_ARENA_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Allocates blocks of a single size from large chunks, so the nodes of a container are close
+ * together in memory. Freed blocks are reused by later allocations, and the memory is only
+ * returned when the arena is destroyed. Allocations of any other size use the global heap. The
+ * arena is not thread safe.
+ */
+struct MIGRAPHX_EXPORT arena
+{
+    arena() = default;
+
+    // Copies start with an empty arena, since the blocks belong to the container that allocated
+    // them
+    arena(const arena&) {}
+    arena& operator=(const arena&) { return *this; }
+
+    ~arena();
+
+    void* allocate(std::size_t n);
+
+    void deallocate(void* p, std::size_t n);
+
+    /// Whether `p` points into a block that is currently allocated from this arena
+    bool contains(const void* p) const;
+
+    private:
+    struct chunk
+    {
+        char* data          = nullptr;
+        std::size_t nblocks = 0;
+        std::vector<bool> live;
+    };
+    // Index of the chunk containing `p`, or the number of chunks if there is none
+    std::size_t find_chunk(const void* p) const;
+    std::size_t block_index(std::size_t i, const void* p) const;
+
+    std::size_t block_size = 0;
+    // Sorted by address
+    std::vector<chunk> chunks;
+    std::vector<void*> free_blocks;
+    char* next           = nullptr;
+    std::size_t nunused  = 0;
+    std::size_t capacity = 0;
+};
+
+/// Allocator for the nodes of a container that uses an `arena`, or the global heap when there is
+/// no arena
+template <class T>
+struct arena_allocator
+{
+    using value_type = T;
+
+    arena_allocator() = default;
+
+    explicit arena_allocator(arena* a) : pool(a) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& x) : pool(x.pool)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if(pool == nullptr)
+            return std::allocator<T>{}.allocate(n);
+        return static_cast<T*>(pool->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if(pool == nullptr)
+            std::allocator<T>{}.deallocate(p, n);
+        else
+            pool->deallocate(p, n * sizeof(T));
+    }
+
+    friend bool operator==(const arena_allocator& x, const arena_allocator& y)
+    {
+        return x.pool == y.pool;
+    }
+
+    friend bool operator!=(const arena_allocator& x, const arena_allocator& y)
+    {
+        return not(x == y);
+    }
+
+    arena* pool = nullptr;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_ARENA_HPP
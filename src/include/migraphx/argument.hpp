@@ -27,6 +27,7 @@
 #include <migraphx/shape.hpp>
 #include <migraphx/raw_data.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/host_allocator.hpp>
 #include <migraphx/make_shared_array.hpp>
 #include <functional>
 #include <utility>
@@ -59,18 +60,22 @@ struct MIGRAPHX_EXPORT argument : raw_data<argument>
     argument(shape s, T* d)
         : m_shape(std::move(s))
     {
-        assign_buffer([d] { return reinterpret_cast<char*>(d); });
+        // Doesn't own the buffer
+        assign_buffer(std::shared_ptr<char>{std::shared_ptr<char>{}, reinterpret_cast<char*>(d)});
     }
 
     template <class T>
     argument(shape s, std::shared_ptr<T> d)
         : m_shape(std::move(s))
     {
-        assign_buffer([d] { return reinterpret_cast<char*>(d.get()); });
+        assign_buffer(std::shared_ptr<char>{d, reinterpret_cast<char*>(d.get())});
     }
 
     argument(shape s, std::nullptr_t);
-    
+
+    /// Allocates a buffer without zeroing it, for results that write every element
+    static argument uninitialized(const shape& s);
+
     argument(const std::vector<argument>& args);
 
     /// Provides a raw pointer to the data
@@ -105,9 +110,12 @@ struct MIGRAPHX_EXPORT argument : raw_data<argument>
 
     private:
     void assign_buffer(std::function<char*()> d);
+    void assign_buffer(std::shared_ptr<char> b);
     struct data_t
     {
         std::function<char*()> get = nullptr;
+        // Buffers that are already allocated are held directly, so `data` doesn't go through `get`
+        std::shared_ptr<char> buffer = nullptr;
         std::vector<data_t> sub = {};
         data_t share() const;
         static data_t from_args(const std::vector<argument>& args);
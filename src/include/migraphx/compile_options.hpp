@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/tracer.hpp>
+#include <memory>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -41,7 +42,22 @@ struct compile_options
     bool fast_math       = true;
     bool exhaustive_tune = false;
 
+    /**
+     * When set, a program with dynamic input shapes is compiled for the static shapes of its
+     * inputs the first time they are seen when it is evaluated, instead of being compiled for the
+     * whole range of the dynamic shapes. At most this many specializations are kept.
+     *
+     * The program itself keeps the uncompiled dynamic module, so get_output_shapes, print and
+     * the other methods that inspect the modules report the dynamic shapes. A saved program is
+     * written uncompiled, and has to be compiled again after it is loaded.
+     */
+    std::size_t max_specializations = 0;
+
     tracer trace{};
+
+    /// When set, the time and instruction counts of every pass run during compilation are
+    /// recorded in it
+    std::shared_ptr<pass_profile> profile = nullptr;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -29,6 +29,8 @@
 #include <migraphx/par_for.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 namespace migraphx {
@@ -38,60 +40,74 @@ template <class Output, class T, class Padding, class Stride, class Dilation>
 void convolution(
     Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
 {
-    auto output_shape = output.get_shape();
-    auto in_lens      = input.get_shape().lens();
+    auto output_shape       = output.get_shape();
+    const auto& in_lens     = input.get_shape().lens();
+    const auto& in_strides  = input.get_shape().strides();
+    const auto& wei_lens    = weights.get_shape().lens();
+    const auto& wei_strides = weights.get_shape().strides();
 
-    auto wei_lens = weights.get_shape().lens();
     auto wei_n    = wei_lens[0];
     auto wei_c    = wei_lens[1];
-    std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+    auto nspatial = wei_lens.size() - 2;
 
     par_for(output_shape.elements(), [&](auto i) {
-        auto idx_o = output_shape.multi(i);
-        auto w     = idx_o[1];
-        auto n_dim = idx_o.size();
+        auto idx_o          = output_shape.multi(i);
+        auto w              = idx_o[1];
+        const auto group_id = w / (wei_n / group);
 
-        std::vector<std::ptrdiff_t> win_start;
-        for(std::size_t dim = 2; dim < n_dim; ++dim)
+        // Only the part of the window inside of the input is visited, which is the kernel
+        // indices [first, last) in each spatial dimension
+        std::vector<std::ptrdiff_t> first(nspatial);
+        std::vector<std::ptrdiff_t> last(nspatial);
+        auto in_channel = group_id * wei_c;
+        auto in_start   = std::ptrdiff_t(idx_o[0] * in_strides[0] + in_channel * in_strides[1]);
+        auto wei_start  = std::ptrdiff_t(w * wei_strides[0]);
+        bool empty      = false;
+        for(std::size_t d = 0; d < nspatial; d++)
         {
-            auto d_2 = dim - 2;
-            win_start.push_back(std::ptrdiff_t(idx_o[dim] * stride[d_2]) -
-                                std::ptrdiff_t(padding[d_2]));
+            auto start = std::ptrdiff_t(idx_o[d + 2] * stride[d]) - std::ptrdiff_t(padding[d]);
+            auto dil   = std::ptrdiff_t(dilation[d]);
+            auto len   = std::ptrdiff_t(in_lens[d + 2]);
+            first[d]   = start < 0 ? (dil - 1 - start) / dil : 0;
+            last[d]    = std::min(std::ptrdiff_t(wei_lens[d + 2]), (len - start + dil - 1) / dil);
+            if(last[d] <= first[d])
+                empty = true;
+            in_start += (start + first[d] * dil) * std::ptrdiff_t(in_strides[d + 2]);
+            wei_start += first[d] * std::ptrdiff_t(wei_strides[d + 2]);
         }
-        const auto group_id = w / (wei_n / group);
-
-        shape win_shape{output_shape.type(), win_size};
 
         double acc = 0.0;
-        shape_for_each(win_shape, [&](const auto& idx_win) {
-            auto k           = idx_win[0];
-            const auto in_ch = group_id * wei_c + k;
-            std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-            idx[1] = in_ch;
-            std::vector<std::ptrdiff_t> idx_dil(idx_win.size() - 1);
-            std::transform(idx_win.cbegin() + 1,
-                           idx_win.cend(),
-                           dilation.cbegin(),
-                           idx_dil.begin(),
-                           [](std::ptrdiff_t ii, std::ptrdiff_t d) { return d * ii; });
-            std::transform(idx_dil.begin(),
-                           idx_dil.end(),
-                           win_start.begin(),
-                           idx.begin() + 2,
-                           [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-            std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-            idx_wei[0] = w;
-            std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-            if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-               std::equal(idx.begin(),
-                          idx.end(),
-                          in_lens.begin(),
-                          in_lens.end(),
-                          std::less<std::ptrdiff_t>{}))
+        if(not empty)
+        {
+            std::vector<std::ptrdiff_t> idx(nspatial);
+            for(std::size_t k = 0; k < wei_c; k++)
             {
-                acc += input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
+                auto in_pos  = in_start + std::ptrdiff_t(k * in_strides[1]);
+                auto wei_pos = wei_start + std::ptrdiff_t(k * wei_strides[1]);
+                std::copy(first.begin(), first.end(), idx.begin());
+                // Walk the window like an odometer, moving the positions along with it
+                for(;;)
+                {
+                    acc += input.data()[in_pos] * weights.data()[wei_pos];
+                    std::size_t d = nspatial;
+                    for(; d > 0; d--)
+                    {
+                        auto in_step  = std::ptrdiff_t(dilation[d - 1] * in_strides[d + 1]);
+                        auto wei_step = std::ptrdiff_t(wei_strides[d + 1]);
+                        in_pos += in_step;
+                        wei_pos += wei_step;
+                        if(++idx[d - 1] < last[d - 1])
+                            break;
+                        auto n = last[d - 1] - first[d - 1];
+                        in_pos -= n * in_step;
+                        wei_pos -= n * wei_step;
+                        idx[d - 1] = first[d - 1];
+                    }
+                    if(d == 0)
+                        break;
+                }
             }
-        });
+        }
 
         output[i] = acc;
     });
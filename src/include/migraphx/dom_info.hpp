@@ -28,6 +28,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/instruction.hpp>
 #include <unordered_map>
+#include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -36,9 +37,12 @@ struct module;
 
 struct MIGRAPHX_EXPORT dominator_info
 {
-    bool strictly_dominate(instruction_ref ins1, instruction_ref ins2);
+    bool strictly_dominate(instruction_ref ins1, instruction_ref ins2) const;
 
     std::unordered_map<instruction_ref, instruction_ref> ins2idom;
+    // The numbers at which each node is entered and left in a depth-first walk of the dominator
+    // tree. When empty, dominance is checked by walking up the immediate dominators.
+    std::unordered_map<instruction_ref, std::pair<std::size_t, std::size_t>> ins2interval;
 };
 
 MIGRAPHX_EXPORT dominator_info compute_dominator(module& m);
@@ -39,6 +39,7 @@ struct module;
 struct MIGRAPHX_EXPORT eliminate_common_subexpression
 {
     std::string name() const { return "eliminate_common_subexpression"; }
+    bool is_module_local() const { return true; }
     void apply(module& m) const;
 };
 
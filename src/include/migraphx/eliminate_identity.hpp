@@ -41,6 +41,7 @@ struct module;
 struct MIGRAPHX_EXPORT eliminate_identity
 {
     std::string name() const { return "eliminate_identity"; }
+    bool is_module_local() const { return true; }
     void apply(module& m) const;
 };
 
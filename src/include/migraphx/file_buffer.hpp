@@ -26,7 +26,9 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace migraphx {
@@ -36,6 +38,10 @@ MIGRAPHX_EXPORT std::vector<char>
 read_buffer(const fs::path& filename, size_t offset = 0, size_t nbytes = 0);
 MIGRAPHX_EXPORT std::string read_string(const fs::path& filename);
 
+/// Map a whole file into memory and return the buffer along with its size. Pages are only read
+/// from disk when they are first touched, and writes to the buffer are never written back.
+MIGRAPHX_EXPORT std::pair<std::shared_ptr<char>, std::size_t> map_buffer(const fs::path& filename);
+
 MIGRAPHX_EXPORT void write_buffer(const fs::path& filename, const char* buffer, std::size_t size);
 MIGRAPHX_EXPORT void write_buffer(const fs::path& filename, const std::vector<char>& buffer);
 
@@ -25,37 +25,230 @@
 #define MIGRAPHX_GUARD_RTGLIB_GEMM_HPP
 
 #include <migraphx/config.hpp>
-#include <migraphx/dfor.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/simple_par_for.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+namespace gemm_detail {
+
+// Integers are accumulated exactly, 8-bit inputs use int32 like quant_dot does, everything
+// else is accumulated in double
+template <class T>
+using gemm_accumulator = std::conditional_t<
+    std::is_integral<T>{},
+    std::conditional_t<(sizeof(T) == 1), std::int32_t, std::int64_t>,
+    double>;
+
+// Register block computed by the micro kernel
+constexpr std::size_t mr = 4;
+constexpr std::size_t nr = 8;
+// Cache blocks: a packed mc x kc block of A and kc x nc block of B are reused
+// across all of the micro kernel calls of an output tile
+constexpr std::size_t mc = 64;
+constexpr std::size_t nc = 128;
+constexpr std::size_t kc = 256;
+
+struct matrix_layout
+{
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t row_stride;
+    std::size_t col_stride;
+    // Element offset of every batch
+    std::vector<std::size_t> batch_offsets;
+};
+
+inline matrix_layout compute_layout(const shape& s, const std::vector<std::size_t>& batch_lens)
+{
+    const auto& lens    = s.lens();
+    const auto& strides = s.strides();
+    const auto n        = lens.size();
+    matrix_layout result{lens[n - 2], lens[n - 1], strides[n - 2], strides[n - 1], {}};
+    std::size_t nbatch = std::accumulate(
+        batch_lens.begin(), batch_lens.end(), std::size_t{1}, std::multiplies<>{});
+    result.batch_offsets.resize(nbatch);
+    // Broadcasted batch dimensions have a zero stride, so they are never materialized
+    for(std::size_t b = 0; b < nbatch; b++)
+    {
+        std::size_t offset = 0;
+        std::size_t idx    = b;
+        for(std::size_t d = batch_lens.size(); d > 0; d--)
+        {
+            offset += (idx % batch_lens[d - 1]) * strides[d - 1];
+            idx /= batch_lens[d - 1];
+        }
+        result.batch_offsets[b] = offset;
+    }
+    return result;
+}
+
+// Pack rows [i, i+m) and columns [p, p+k) of A into panels of mr rows, zero
+// padding the last panel
+template <class Acc, class U>
+void pack_a(Acc* dst,
+            const U* a,
+            const matrix_layout& l,
+            std::size_t i,
+            std::size_t p,
+            std::size_t m,
+            std::size_t k)
+{
+    for(std::size_t ir = 0; ir < m; ir += mr)
+    {
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            const U* src = a + (i + ir) * l.row_stride + (p + kk) * l.col_stride;
+            for(std::size_t r = 0; r < mr; r++)
+                *dst++ = (ir + r < m) ? static_cast<Acc>(src[r * l.row_stride]) : Acc{0};
+        }
+    }
+}
+
+// Pack rows [p, p+k) and columns [j, j+n) of B into panels of nr columns, zero
+// padding the last panel
+template <class Acc, class U>
+void pack_b(Acc* dst,
+            const U* b,
+            const matrix_layout& l,
+            std::size_t p,
+            std::size_t j,
+            std::size_t k,
+            std::size_t n)
+{
+    for(std::size_t jr = 0; jr < n; jr += nr)
+    {
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            const U* src = b + (p + kk) * l.row_stride + (j + jr) * l.col_stride;
+            for(std::size_t c = 0; c < nr; c++)
+                *dst++ = (jr + c < n) ? static_cast<Acc>(src[c * l.col_stride]) : Acc{0};
+        }
+    }
+}
+
+// Computes an mr x nr block of the product from packed panels. The fixed size
+// accumulator lets the compiler keep it in vector registers.
+template <class Acc>
+void micro_kernel(std::size_t k, const Acc* a, const Acc* b, Acc* c, std::size_t ldc)
+{
+    Acc acc[mr][nr] = {};
+    for(std::size_t kk = 0; kk < k; kk++)
+    {
+        for(std::size_t r = 0; r < mr; r++)
+        {
+            const Acc x = a[r];
+            for(std::size_t s = 0; s < nr; s++)
+                acc[r][s] += x * b[s];
+        }
+        a += mr;
+        b += nr;
+    }
+    for(std::size_t r = 0; r < mr; r++)
+    {
+        for(std::size_t s = 0; s < nr; s++)
+            c[r * ldc + s] += acc[r][s];
+    }
+}
+
+template <class T, class Acc, class F>
+T scale(Acc x, const T* c, F alpha, F beta)
+{
+    if(float_equal(beta, F{0}))
+    {
+        if(float_equal(alpha, F{1}))
+            return static_cast<T>(x);
+        return static_cast<T>(static_cast<double>(alpha) * static_cast<double>(x));
+    }
+    return static_cast<T>(static_cast<double>(alpha) * static_cast<double>(x) +
+                          static_cast<double>(beta) * static_cast<double>(*c));
+}
+
+} // namespace gemm_detail
+
+/**
+ * Computes `C = alpha * A * B + beta * C` over the last two dimensions, with
+ * the leading dimensions treated as batches. The operands are read through
+ * their strides, so transposed and broadcasted inputs are not copied. Output
+ * tiles are computed in parallel from packed, cache sized blocks of A and B.
+ * When `beta` is zero the previous contents of C are not read.
+ */
 template <class T, class U, class F>
 void gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
-    std::size_t dim_0  = n_dims - 2;
-    std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
-
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
-
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
-                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+    using namespace gemm_detail; // NOLINT
+    using acc_type = gemm_accumulator<std::remove_cv_t<U>>;
+
+    const auto& cs = cmat.get_shape();
+    std::vector<std::size_t> batch_lens(cs.lens().begin(), cs.lens().end() - 2);
+    auto al = compute_layout(amat.get_shape(), batch_lens);
+    auto bl = compute_layout(bmat.get_shape(), batch_lens);
+    auto cl = compute_layout(cs, batch_lens);
+
+    assert(al.cols == bl.rows);
+    assert(cl.rows == al.rows);
+    assert(cl.cols == bl.cols);
+    const std::size_t m = cl.rows;
+    const std::size_t n = cl.cols;
+    const std::size_t k = al.cols;
+
+    const std::size_t mtiles = (m + mc - 1) / mc;
+    const std::size_t ntiles = (n + nc - 1) / nc;
+    const std::size_t ntasks = cl.batch_offsets.size() * mtiles * ntiles;
+
+    // Every task computes a whole output tile, so it is worth running them in parallel even
+    // when there are only a few of them
+    simple_par_for(ntasks, 1, [&](std::size_t task) {
+        const std::size_t batch = task / (mtiles * ntiles);
+        const std::size_t i     = ((task / ntiles) % mtiles) * mc;
+        const std::size_t j     = (task % ntiles) * nc;
+        const std::size_t mb    = std::min(mc, m - i);
+        const std::size_t nb    = std::min(nc, n - j);
+        // Round up to whole register blocks so the micro kernel never goes out of bounds
+        const std::size_t mpad = (mb + mr - 1) / mr * mr;
+        const std::size_t npad = (nb + nr - 1) / nr * nr;
+
+        std::vector<acc_type> apack(mpad * std::min(k, kc));
+        std::vector<acc_type> bpack(npad * std::min(k, kc));
+        std::vector<acc_type> ctile(mpad * npad, acc_type{0});
+
+        const U* a = amat.data() + al.batch_offsets[batch];
+        const U* b = bmat.data() + bl.batch_offsets[batch];
+        for(std::size_t p = 0; p < k; p += kc)
+        {
+            const std::size_t kb = std::min(kc, k - p);
+            pack_a(apack.data(), a, al, i, p, mb, kb);
+            pack_b(bpack.data(), b, bl, p, j, kb, nb);
+            for(std::size_t jr = 0; jr < nb; jr += nr)
+            {
+                for(std::size_t ir = 0; ir < mb; ir += mr)
+                {
+                    micro_kernel(kb,
+                                 apack.data() + ir * kb,
+                                 bpack.data() + jr * kb,
+                                 ctile.data() + ir * npad + jr,
+                                 npad);
+                }
+            }
+        }
+
+        T* c = cmat.data() + cl.batch_offsets[batch];
+        for(std::size_t ii = 0; ii < mb; ii++)
+        {
+            for(std::size_t jj = 0; jj < nb; jj++)
+            {
+                T* out = c + (i + ii) * cl.row_stride + (j + jj) * cl.col_stride;
+                *out   = scale(ctile[ii * npad + jj], out, alpha, beta);
+            }
+        }
     });
 }
 
@@ -0,0 +1,66 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_HOST_ALLOCATOR_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_HOST_ALLOCATOR_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Alignment of every host buffer, which is enough for any vector load
+constexpr std::size_t host_buffer_alignment = 64;
+
+/**
+ * Allocates a host buffer for arguments and literals. The size of a buffer up to 8 megabytes is
+ * rounded up to a size class, and when the buffer is released it is kept in a pool for its size
+ * class, so evaluating a program again reuses the buffers of the previous run instead of going
+ * to the heap. The pools hold at most MIGRAPHX_HOST_BUFFER_POOL_SIZE megabytes. Larger buffers
+ * are only rounded up to the alignment and are never pooled. The buffer is zeroed unless `zero` is
+ * false, which should only be used when every byte is written before it is read. This is thread
+ * safe.
+ */
+MIGRAPHX_EXPORT std::shared_ptr<char> allocate_host_buffer(std::size_t n, bool zero = true);
+
+/// Returns the buffers kept in the pools to the heap
+MIGRAPHX_EXPORT void release_host_buffers();
+
+struct host_buffer_stats
+{
+    /// Number of buffers allocated with `allocate_host_buffer`
+    std::size_t allocations = 0;
+    /// Number of those that were not in a pool and came from the heap
+    std::size_t heap_allocations = 0;
+    /// Bytes currently kept in the pools
+    std::size_t pooled_bytes = 0;
+};
+
+MIGRAPHX_EXPORT host_buffer_stats get_host_buffer_stats();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_HOST_ALLOCATOR_HPP
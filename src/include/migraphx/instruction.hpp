@@ -31,6 +31,7 @@
 #include <migraphx/operation.hpp>
 #include <migraphx/erase.hpp>
 #include <migraphx/config.hpp>
+#include <cstdint>
 #include <string>
 #include <utility>
 
@@ -131,6 +132,11 @@ struct MIGRAPHX_EXPORT instruction
 
     static instruction_ref get_output_alias(instruction_ref ins, bool shallow = false);
 
+    // Whether the operator writes into the input its output aliases. Views alias their first
+    // input, while operators that write into a buffer, such as fill, take it after their other
+    // inputs.
+    static bool writes_output_alias(instruction_ref ins);
+
     void set_normalized(bool value = true);
     bool is_normalized() const;
 
@@ -149,6 +155,9 @@ struct MIGRAPHX_EXPORT instruction
                       const std::unordered_map<instruction_ref, std::string>& names);
 
     private:
+    // The module assigns the ordinals
+    friend struct module_impl;
+
     // internal
     void replace(operation o, const shape& r, std::vector<instruction_ref> args);
 
@@ -180,6 +189,8 @@ struct MIGRAPHX_EXPORT instruction
     literal lit;
     bool normalized       = false;
     std::size_t target_id = 0;
+    // Increases with the position of the instruction in its module
+    std::uint64_t ordinal = 0;
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
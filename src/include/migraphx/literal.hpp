@@ -29,7 +29,7 @@
 #include <migraphx/argument.hpp>
 #include <migraphx/tensor_view.hpp>
 #include <migraphx/raw_data.hpp>
-#include <migraphx/make_shared_array.hpp>
+#include <migraphx/host_allocator.hpp>
 #include <migraphx/config.hpp>
 
 #include <memory>
@@ -51,42 +51,42 @@ struct literal : raw_data<literal>
     explicit literal(shape::type_t shape_type) : m_shape(shape_type, {}) {}
 
     template <class U, class T = deduce<U>, shape::type_t ShapeType = shape::get_type<T>{}>
-    literal(U x) : buffer(make_shared_array<char>(sizeof(T))), m_shape(ShapeType)
+    literal(U x) : buffer(allocate_host_buffer(sizeof(T), false)), m_shape(ShapeType)
     {
         static_assert(std::is_trivially_copyable<T>{}, "Literals can only be trivial types");
         *(reinterpret_cast<T*>(buffer.get())) = x;
     }
 
     template <class T>
-    literal(const shape& s, const std::vector<T>& x)
-        : buffer(make_shared_array<char>(s.bytes())), m_shape(s)
+    literal(const shape& s, const std::vector<T>& x) : buffer(allocate(s)), m_shape(s)
     {
         static_assert(std::is_trivially_copyable<T>{}, "Literals can only be trivial types");
         fill(x.begin(), x.end());
     }
 
     template <class T>
-    literal(const shape& s, const std::initializer_list<T>& x)
-        : buffer(make_shared_array<char>(s.bytes())), m_shape(s)
+    literal(const shape& s, const std::initializer_list<T>& x) : buffer(allocate(s)), m_shape(s)
     {
         static_assert(std::is_trivially_copyable<T>{}, "Literals can only be trivial types");
         fill(x.begin(), x.end());
     }
 
     template <class Iterator>
-    literal(const shape& s, Iterator start, Iterator end)
-        : buffer(make_shared_array<char>(s.bytes())), m_shape(s)
+    literal(const shape& s, Iterator start, Iterator end) : buffer(allocate(s)), m_shape(s)
     {
         fill(start, end);
     }
 
     // Directly copies buffer of x
     template <class T, MIGRAPHX_REQUIRES(sizeof(T) == 1)>
-    literal(const shape& s, T* x) : buffer(make_shared_array<char>(s.bytes())), m_shape(s)
+    literal(const shape& s, T* x) : buffer(allocate_host_buffer(s.bytes(), false)), m_shape(s)
     {
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Shares the buffer without copying it, the buffer must hold at least `s.bytes()` bytes
+    literal(const shape& s, std::shared_ptr<char> x) : buffer(std::move(x)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -100,14 +100,24 @@ struct literal : raw_data<literal>
     /// Convert the data to an argument
     argument get_argument() const
     {
-        auto b = make_shared_array<char>(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() { return b.get(); }};
+        auto b = allocate_host_buffer(m_shape.bytes(), false);
+        std::copy(buffer.get(), buffer.get() + m_shape.bytes(), b.get());
+        return {m_shape, b};
     }
 
+    /// Convert to an argument that shares the buffer of the literal instead of copying it
+    argument share_argument() const { return {m_shape, buffer}; }
+
     private:
     std::shared_ptr<char> buffer;
     shape m_shape;
 
+    // Every element is filled in, so only the gaps of shapes that aren't packed need zeroing
+    static std::shared_ptr<char> allocate(const shape& s)
+    {
+        return allocate_host_buffer(s.bytes(), not s.packed());
+    }
+
     // Keeps the same data ordering as the given container
     template <class Iterator>
     void fill(Iterator start, Iterator end)
@@ -32,6 +32,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/ranges.hpp>
 #include <unordered_set>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -72,6 +73,38 @@ void liveness(const module& m, F f)
     }
 }
 
+// This will call the function `f` with each instruction and the inputs of
+// the module that are used for the last time by that instruction, which
+// includes the inputs used by its submodules
+template <class F>
+void last_uses(const module& m, F f)
+{
+    auto implicit_deps = m.calc_implicit_deps();
+    std::unordered_set<instruction_ref> used;
+    std::vector<instruction_ref> last;
+    auto rp = reverse(m);
+    for(auto rins : iterator_for(rp)) // NOLINT
+    {
+        // The base iterator is one ahead, so we need to use the previous iterator
+        auto ins = std::prev(rins.base());
+        last.clear();
+        auto add_used_variables = [&](const auto& inputs) {
+            for(auto input : inputs)
+            {
+                // Skip if variable comes from parent
+                if(not m.has_instruction(input))
+                    continue;
+                if(used.insert(input).second)
+                    last.push_back(input);
+            }
+        };
+        add_used_variables(ins->inputs());
+        add_used_variables(implicit_deps[ins]);
+        if(not last.empty())
+            f(ins, last);
+    }
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 #endif // MIGRAPHX_GUARD_MIGRAPHX_LIVENESS_HPP
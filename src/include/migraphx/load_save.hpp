@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_LOAD_SAVE_HPP
 
 #include <migraphx/program.hpp>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,8 @@ MIGRAPHX_EXPORT program load_buffer(const char* buffer,
 
 MIGRAPHX_EXPORT void
 save(const program& p, const std::string& filename, const file_options& options = file_options{});
+MIGRAPHX_EXPORT void
+save(const program& p, std::ostream& os, const file_options& options = file_options{});
 MIGRAPHX_EXPORT std::vector<char> save_buffer(const program& p,
                                               const file_options& options = file_options{});
 
@@ -24,7 +24,10 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_MATCHER_HPP
 #define MIGRAPHX_GUARD_RTGLIB_MATCHER_HPP
 
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/errors.hpp>
 #include <migraphx/float_equal.hpp>
+#include <migraphx/hash.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/instruction.hpp>
@@ -34,7 +37,9 @@
 #include <migraphx/type_name.hpp>
 #include <migraphx/source_location.hpp>
 #include <migraphx/config.hpp>
+#include <algorithm>
 #include <array>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -193,6 +198,29 @@ struct id_matcher
     }
 };
 
+/// A matcher whose root instruction can only have one of the names
+template <class M>
+struct named_matcher
+{
+    M m;
+    std::vector<std::string> names;
+
+    auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+};
+
+/// Keep the root names of matcher m on a matcher f built from it
+template <class M, class F>
+F with_root_names(const M&, F f)
+{
+    return f;
+}
+
+template <class M, class F>
+named_matcher<F> with_root_names(const named_matcher<M>& m, F f)
+{
+    return {f, m.names};
+}
+
 // Forward declare class and constructors
 template <class M>
 struct basic_matcher;
@@ -229,21 +257,26 @@ struct basic_matcher
     {
         // Copy m because we cant capture `this` by value
         auto mm = m;
-        return make_basic_fun_matcher([=](matcher_context& ctx,
-                                          instruction_ref ins) -> optional<instruction_ref> {
-            auto result = mm.match(ctx, ins);
-            if(result)
-            {
-                bool matches =
-                    fold([&](auto x, auto y) { return x and ctx.matched(y, result); })(true, ms...);
-                if(matches)
-                    return result;
-            }
-            return nullopt;
-        });
+        auto f  = make_function_matcher(
+            [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
+                auto result = mm.match(ctx, ins);
+                if(result)
+                {
+                    bool matches = fold([&](auto x, auto y) {
+                        return x and ctx.matched(y, result);
+                    })(true, ms...);
+                    if(matches)
+                        return result;
+                }
+                return nullopt;
+            });
+        return make_basic_matcher(with_root_names(m, f));
     }
 
-    auto bind(std::string name) const { return bind_match(m, std::move(name)); }
+    auto bind(std::string name) const
+    {
+        return with_root_names(m, bind_match(m, std::move(name)));
+    }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
 };
@@ -280,6 +313,25 @@ auto make_basic_pred_matcher(P p)
     return make_basic_matcher(make_predicate_matcher(p));
 }
 
+/// Get the names the root instruction of a matcher can have, or nullopt if it can have any name
+template <class M>
+optional<std::vector<std::string>> get_root_names(const M&)
+{
+    return nullopt;
+}
+
+template <class M>
+optional<std::vector<std::string>> get_root_names(const named_matcher<M>& m)
+{
+    return m.names;
+}
+
+template <class M>
+optional<std::vector<std::string>> get_root_names(const basic_matcher<M>& m)
+{
+    return get_root_names(m.m);
+}
+
 /// This macro takes care of the boilerplate for defining a matcher
 #define MIGRAPHX_BASIC_MATCHER(name, ...)                                     \
     struct name##_m                                                           \
@@ -372,54 +424,132 @@ match::matcher_result find_match(module& modl, M&& m)
     return result;
 }
 
+/// The matchers of a list of finders, indexed by the names their root instruction can have so
+/// that only the matchers that can match an instruction are tried
+template <class... Fs>
+struct matcher_index
+{
+    matcher_index(const Fs&... fs) : finders(fs...), matchers(fs.matcher()...)
+    {
+        repeat_c<sizeof...(Fs)>(
+            [&](auto i) { root_names.push_back(get_root_names(std::get<i>(matchers))); });
+    }
+
+    /// Whether each matcher could match an instruction with the name
+    const std::vector<bool>& candidates(const std::string& name)
+    {
+        auto it = candidates_by_name.find(name);
+        if(it != candidates_by_name.end())
+            return it->second;
+        std::vector<bool> result;
+        std::transform(root_names.begin(),
+                       root_names.end(),
+                       std::back_inserter(result),
+                       [&](const auto& names) { return not names or contains(*names, name); });
+        return candidates_by_name.emplace(name, std::move(result)).first->second;
+    }
+
+    template <class F>
+    void for_each(F f) const
+    {
+        repeat_c<sizeof...(Fs)>(
+            [&](auto i) { f(i, std::get<i>(finders), std::get<i>(matchers)); });
+    }
+
+    private:
+    std::tuple<const Fs&...> finders;
+    std::tuple<decltype(std::declval<const Fs&>().matcher())...> matchers;
+    std::vector<optional<std::vector<std::string>>> root_names;
+    std::unordered_map<std::string, std::vector<bool>> candidates_by_name;
+};
+
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES_FOR)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_VALIDATE_MATCHES)
 
-/// Find matches for an instruction in the module for per section of matchers
-template <class Mod, class... Ms>
-void find_matches_for(source_location location, Mod& mod, instruction_ref ins, Ms&&... ms)
+/// Hash the matched instructions with their operators and connections, to tell if applying a
+/// finder changed the module
+inline std::size_t hash_match(const module& m, const matcher_result& r)
+{
+    std::size_t h = hash_value(m.size());
+    auto hash_ins = [&](instruction_ref ins) {
+        hash_combine(h, m.has_instruction(ins));
+        if(not m.has_instruction(ins))
+            return;
+        hash_combine(h, ins->get_operator().name());
+        hash_combine(h, ins->get_operator().to_value().hash());
+        for(auto input : ins->inputs())
+            hash_combine(h, input);
+        for(auto output : ins->outputs())
+            hash_combine(h, output);
+    };
+    hash_ins(r.result);
+    for(const auto& p : r.instructions)
+        hash_ins(p.second);
+    return h;
+}
+
+/// Apply the first finder in the index that matches the instruction, and return its match. When
+/// `track_changes` is set, the match is only returned if applying it changed the module.
+template <class Mod, class... Fs>
+optional<matcher_result> apply_first_match(source_location location,
+                                           Mod& mod,
+                                           instruction_ref ins,
+                                           matcher_index<Fs...>& index,
+                                           bool track_changes = false)
 {
     const int trace         = value_of(MIGRAPHX_TRACE_MATCHES{});
     const bool validate     = enabled(MIGRAPHX_VALIDATE_MATCHES{});
     const auto trace_filter = string_value_of(MIGRAPHX_TRACE_MATCHES_FOR{});
-    bool match              = false;
-    each_args(
-        [&](auto&& m) {
-            const auto& matcher_name = get_type_name(m);
-            const bool trace_for     = not trace_filter.empty() and
-                                   (contains(std::string{location.file_name()}, trace_filter) or
-                                    contains(std::string{location.function_name()}, trace_filter) or
-                                    contains(matcher_name, trace_filter));
-            if(match)
-                return;
-            if(trace > 1 and trace_for)
-                std::cout << "Match: " << matcher_name << std::endl;
-            auto r = match_instruction(get_module(mod), ins, m.matcher());
-            if(r.result == get_module(mod).end())
-                return;
-            if(trace > 0 or trace_for)
-            {
-                std::cout << "Matched by " << matcher_name << std::endl;
-                get_module(mod).debug_print(ins);
-            }
-            // If its already invalid dont validate it again
-            bool invalidated = validate and get_module(mod).validate() != get_module(mod).end();
-            m.apply(mod, r);
-            if(validate and not invalidated)
+    const auto& candidates  = index.candidates(ins->name());
+    bool matched = false;
+    optional<matcher_result> match;
+    index.for_each([&](auto i, auto&& m, auto&& matcher) {
+        if(matched or not candidates[i])
+            return;
+        const auto& matcher_name = get_type_name(m);
+        const bool trace_for     = not trace_filter.empty() and
+                               (contains(std::string{location.file_name()}, trace_filter) or
+                                contains(std::string{location.function_name()}, trace_filter) or
+                                contains(matcher_name, trace_filter));
+        if(trace > 1 and trace_for)
+            std::cout << "Match: " << matcher_name << std::endl;
+        auto r = match_instruction(get_module(mod), ins, matcher);
+        if(r.result == get_module(mod).end())
+            return;
+        if(trace > 0 or trace_for)
+        {
+            std::cout << "Matched by " << matcher_name << std::endl;
+            get_module(mod).debug_print(ins);
+        }
+        // If its already invalid dont validate it again
+        bool invalidated = validate and get_module(mod).validate() != get_module(mod).end();
+        auto h           = track_changes ? hash_match(get_module(mod), r) : 0;
+        m.apply(mod, r);
+        if(validate and not invalidated)
+        {
+            auto invalid = get_module(mod).validate();
+            if(invalid != get_module(mod).end())
             {
-                auto invalid = get_module(mod).validate();
-                if(invalid != get_module(mod).end())
-                {
-                    std::cout << "Invalid program from match: " << matcher_name << std::endl;
-                    std::cout << "Invalid instructions: " << std::endl;
-                    get_module(mod).debug_print(invalid->inputs());
-                    get_module(mod).debug_print(invalid);
-                }
+                std::cout << "Invalid program from match: " << matcher_name << std::endl;
+                std::cout << "Invalid instructions: " << std::endl;
+                get_module(mod).debug_print(invalid->inputs());
+                get_module(mod).debug_print(invalid);
             }
-            match = true;
-        },
-        ms...);
+        }
+        matched = true;
+        if(not track_changes or hash_match(get_module(mod), r) != h)
+            match = r;
+    });
+    return match;
+}
+
+/// Find matches for an instruction in the module for per section of matchers
+template <class Mod, class... Ms>
+void find_matches_for(source_location location, Mod& mod, instruction_ref ins, Ms&&... ms)
+{
+    matcher_index<std::decay_t<Ms>...> index{ms...};
+    apply_first_match(location, mod, ins, index);
 }
 
 /// Find matches in a module
@@ -428,9 +558,10 @@ struct find_matches
 {
     find_matches(Mod& mod, Ms&&... ms, source_location location = source_location::current())
     {
+        matcher_index<std::decay_t<Ms>...> index{ms...};
         for(auto ins : iterator_for(get_module(mod)))
         {
-            find_matches_for(location, mod, ins, ms...);
+            apply_first_match(location, mod, ins, index);
         }
     }
 };
@@ -438,6 +569,114 @@ struct find_matches
 template <class Mod, class... Ms>
 find_matches(Mod& mod, Ms&&... ms) -> find_matches<Mod, Ms...>;
 
+/// Find matches in a module until no more matches are found. The instructions are matched in
+/// rounds, in module order, and dead code is removed after each round. The first round matches
+/// every instruction. After that only the instructions near an instruction that was rewritten, or
+/// whose outputs were removed as dead code, are put on the worklist of the next round. A matcher
+/// can look further away than that, so when a round finds nothing, a full round over the module
+/// confirms the fixpoint. Finders that keep undoing each other never reach a fixpoint, so it
+/// throws once they have applied more rewrites than `max_rewrites_per_instruction` for each
+/// instruction of the module.
+template <class Mod, class... Ms>
+struct find_matches_fixpoint
+{
+    static constexpr std::size_t max_rewrites_per_instruction = 64;
+
+    find_matches_fixpoint(Mod& mod,
+                          Ms&&... ms,
+                          source_location location = source_location::current())
+    {
+        auto& m = get_module(mod);
+        matcher_index<std::decay_t<Ms>...> index{ms...};
+        const std::size_t max_rewrites = max_rewrites_per_instruction * (m.size() + 1);
+        std::size_t rewrites           = 0;
+        // The instructions to match in the next round
+        std::unordered_set<instruction_ref> next;
+        // Matchers can look at the inputs and outputs a couple instructions away from the root
+        auto enqueue = [&](std::vector<instruction_ref> near) {
+            for(std::size_t d = 0; d < 3; d++)
+            {
+                std::vector<instruction_ref> more;
+                for(auto ins : near)
+                {
+                    if(not m.has_instruction(ins) or not next.insert(ins).second or d == 2)
+                        continue;
+                    more.insert(more.end(), ins->inputs().begin(), ins->inputs().end());
+                    more.insert(more.end(), ins->outputs().begin(), ins->outputs().end());
+                }
+                near = std::move(more);
+            }
+        };
+        auto all = [&] {
+            std::vector<instruction_ref> result;
+            result.reserve(m.size());
+            for(auto ins : iterator_for(m))
+                result.push_back(ins);
+            return result;
+        };
+        std::vector<instruction_ref> worklist = all();
+        bool full                             = true;
+        bool first                            = true;
+        for(;;)
+        {
+            bool matched = false;
+            for(auto ins : worklist)
+            {
+                if(not m.has_instruction(ins))
+                    continue;
+                std::vector<instruction_ref> outputs = ins->outputs();
+                auto r = apply_first_match(location, mod, ins, index, true);
+                // Finders can match and leave the module unchanged
+                if(not r)
+                    continue;
+                matched = true;
+                if(++rewrites > max_rewrites)
+                    MIGRAPHX_THROW("find_matches_fixpoint: No fixpoint after " +
+                                   std::to_string(rewrites) + " rewrites");
+                outputs.push_back(ins);
+                for(const auto& p : r->instructions)
+                    outputs.push_back(p.second);
+                enqueue(outputs);
+            }
+            if(matched or first)
+            {
+                // The inputs of dead instructions lose an output when they are removed
+                std::vector<instruction_ref> dead_inputs;
+                for(auto ins : next)
+                {
+                    if(m.has_instruction(ins) and ins->outputs().empty())
+                        dead_inputs.insert(
+                            dead_inputs.end(), ins->inputs().begin(), ins->inputs().end());
+                }
+                dead_code_elimination{}.apply(m);
+                enqueue(dead_inputs);
+            }
+            first = false;
+            if(next.empty())
+            {
+                if(full)
+                    return;
+                worklist = all();
+                full     = true;
+                continue;
+            }
+            worklist.clear();
+            std::copy_if(next.begin(),
+                         next.end(),
+                         std::back_inserter(worklist),
+                         [&](instruction_ref ins) { return m.has_instruction(ins); });
+            std::sort(worklist.begin(), worklist.end(), [&](instruction_ref x, instruction_ref y) {
+                return m.precedes(x, y);
+            });
+            next.clear();
+            full = false;
+        }
+    }
+};
+
+template <class Mod, class... Ms>
+find_matches_fixpoint(Mod& mod, Ms&&... ms) -> find_matches_fixpoint<Mod, Ms...>;
+
 template <class M, class F>
 struct find_generic_match
 {
@@ -700,9 +939,19 @@ inline auto var(std::string s)
         });
 }
 
+/// Create a basic matcher from a predicate function that only matches the names
+template <class P>
+auto make_basic_named_matcher(std::vector<std::string> names, P p)
+{
+    return make_basic_matcher(
+        named_matcher<predicate_matcher<P>>{make_predicate_matcher(p), std::move(names)});
+}
+
 inline auto name(std::string s)
 {
-    return make_basic_pred_matcher(
+    std::vector<std::string> names = {s};
+    return make_basic_named_matcher(
+        std::move(names),
         [=, m_s = std::move(s)](instruction_ref ins) { return ins->name() == m_s; });
 }
 
@@ -714,9 +963,11 @@ inline auto name_contains(const std::string& name)
 
 inline auto name(std::unordered_set<std::string> names)
 {
-    return make_basic_pred_matcher([=, m_names = std::move(names)](instruction_ref ins) {
-        return m_names.count(ins->name()) > 0;
-    });
+    std::vector<std::string> root_names(names.begin(), names.end());
+    return make_basic_named_matcher(std::move(root_names),
+                                    [=, m_names = std::move(names)](instruction_ref ins) {
+                                        return m_names.count(ins->name()) > 0;
+                                    });
 }
 
 template <class... Ts>
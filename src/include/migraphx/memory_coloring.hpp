@@ -34,13 +34,16 @@ struct module;
 
 /**
  * Remove multiple memory allocations using graph coloring to find memory allocations that can be
- * reused.
+ * reused. When use_intervals is set, the allocations are instead placed with a sweep over their
+ * live intervals, which avoids building the interference graph.
  */
 struct MIGRAPHX_EXPORT memory_coloring
 {
     std::string allocation_op{};
-    bool verify = false;
+    bool verify        = false;
+    bool use_intervals = false;
     std::string name() const { return "memory_coloring"; }
+    bool is_module_local() const { return true; }
     void apply(module& m) const;
 };
 
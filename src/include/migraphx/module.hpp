@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_MIGRAPHLIB_MODULE_HPP
 #define MIGRAPHX_GUARD_MIGRAPHLIB_MODULE_HPP
 
+#include <cstdint>
 #include <list>
 #include <unordered_set>
 #include <unordered_map>
@@ -80,6 +81,10 @@ struct MIGRAPHX_EXPORT module
     bool bypass() const;
     void set_bypass(bool b = true);
 
+    /// Changes whenever instructions are added, removed, moved or replaced through the module, so
+    /// state derived from the module can check that it is still up to date
+    std::uint64_t version() const;
+
     template <class... Ts, MIGRAPHX_REQUIRES(std::is_same<Ts, instruction_ref>{}...)>
     instruction_ref add_instruction(operation op, Ts... args)
     {
@@ -196,6 +201,10 @@ struct MIGRAPHX_EXPORT module
 
     bool has_instruction(instruction_ref ins) const;
 
+    /// Whether `x` comes before `y` in the module, which takes constant time. The end of the
+    /// module comes after every instruction.
+    bool precedes(instruction_ref x, instruction_ref y) const;
+
     std::vector<instruction_ref> get_returns() const;
 
     std::size_t size() const;
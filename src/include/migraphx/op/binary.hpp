@@ -94,7 +94,7 @@ struct binary : op_name<Derived>
 
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        auto result = argument::uninitialized(dyn_out.computed_shape);
         visit_all(result, args[0], args[1])([&](auto output, auto input1, auto input2) {
             par_transform(input1.begin(),
                           input1.end(),
@@ -63,10 +63,16 @@ struct contiguous
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         assert(dyn_out.computed_shape.standard());
-        argument result{dyn_out.computed_shape};
+        auto result = argument::uninitialized(dyn_out.computed_shape);
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(output.get_shape(), [&](const auto& idx) {
-                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
+            shape_runs<2> runs{{output.get_shape(), input.get_shape()}};
+            auto n       = runs.length();
+            auto strides = runs.strides();
+            runs.for_each([&](const auto& offsets) {
+                auto* out      = output.data() + offsets[0];
+                const auto* in = input.data() + offsets[1];
+                for(std::size_t k = 0; k < n; k++)
+                    out[k * strides[0]] = in[k * strides[1]];
             });
         });
         return result;
@@ -227,7 +227,7 @@ struct convolution
             }
         }
 
-        argument result{output_shape};
+        auto result = argument::uninitialized(output_shape);
         visit_all(result, args[0], args[1])([&](auto output, auto input, auto weights) {
             migraphx::convolution(output, input, weights, new_padding, stride, dilation, group);
         });
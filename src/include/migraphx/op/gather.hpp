@@ -125,15 +125,35 @@ struct gather
                     auto out_lens  = data.get_shape().lens();
                     out_lens[axis] = indices.get_shape().elements();
                     migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-                    shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                        auto data_idx   = out_idx_v;
-                        auto in_index   = indices[data_idx[axis]];
-                        in_index        = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                    // Copy the slice of the data selected by each index, the shapes of the
+                    // slices leave out the axis
+                    auto slice = [&](const shape& s) {
+                        auto slice_lens    = s.lens();
+                        auto slice_strides = s.strides();
+                        slice_lens.erase(slice_lens.begin() + axis);
+                        slice_strides.erase(slice_strides.begin() + axis);
+                        return shape{s.type(), slice_lens, slice_strides};
+                    };
+                    shape_runs<2> runs{{slice(out_comp_shape), slice(data.get_shape())}};
+                    auto n                = runs.length();
+                    auto strides          = runs.strides();
+                    auto out_axis_stride  = out_comp_shape.strides()[axis];
+                    auto data_axis_stride = data.get_shape().strides()[axis];
+                    for(std::size_t i = 0; i < out_lens[axis]; i++)
+                    {
+                        auto in_index = indices[i];
+                        in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
                         // don't go out of bounds: https://github.com/ROCm/AMDMIGraphX/issues/2838
                         assert(in_index >= 0 and in_index < axis_dim_size);
-                        data_idx[axis]  = in_index;
-                        output[out_idx] = data(data_idx.begin(), data_idx.end());
-                    });
+                        auto out_start  = i * out_axis_stride;
+                        auto data_start = static_cast<std::size_t>(in_index) * data_axis_stride;
+                        runs.for_each([&](const auto& offsets) {
+                            auto* out      = output.data() + out_start + offsets[0];
+                            const auto* in = data.data() + data_start + offsets[1];
+                            for(std::size_t k = 0; k < n; k++)
+                                out[k * strides[0]] = in[k * strides[1]];
+                        });
+                    }
                 }
             });
         });
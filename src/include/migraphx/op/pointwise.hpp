@@ -29,6 +29,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/permutation.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
 #include <migraphx/par_for.hpp>
 
 namespace migraphx {
@@ -64,17 +65,143 @@ struct pointwise
         return shape::from_permutation(type, inputs.front().lens(), find_permutation(inputs));
     }
 
+    // The submodule lowered to a list of operators that each run over a block of elements, so
+    // the submodule is evaluated once per block instead of once per element
+    struct block_program
+    {
+        struct step
+        {
+            operation op;
+            std::vector<std::size_t> inputs;
+            std::size_t output = 0;
+        };
+        // The literals are scalars, which are filled over the block
+        std::vector<std::pair<std::size_t, argument>> literals;
+        std::vector<step> steps;
+        std::size_t nregisters = 0;
+        std::size_t output     = 0;
+
+        // Returns false when the submodule can't be run over blocks
+        bool build(const module& m, const std::vector<std::string>& pnames)
+        {
+            std::unordered_map<instruction_ref, std::size_t> registers;
+            nregisters = pnames.size();
+            for(auto ins : iterator_for(m))
+            {
+                const auto& name = ins->name();
+                if(name == "@param")
+                {
+                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
+                    auto it         = std::find(pnames.begin(), pnames.end(), param_name);
+                    registers[ins]  = it - pnames.begin();
+                }
+                else if(name == "@literal")
+                {
+                    if(ins->get_shape().elements() != 1)
+                        return false;
+                    registers[ins] = nregisters++;
+                    literals.emplace_back(registers[ins], ins->get_literal().get_argument());
+                }
+                else if(name == "@return")
+                {
+                    output = registers.at(ins->inputs().front());
+                    return true;
+                }
+                else
+                {
+                    auto op = ins->normalized_operator();
+                    if(not ins->module_inputs().empty() or not op.is_context_free())
+                        return false;
+                    step st{op, {}, nregisters++};
+                    std::transform(ins->inputs().begin(),
+                                   ins->inputs().end(),
+                                   std::back_inserter(st.inputs),
+                                   [&](instruction_ref i) { return registers.at(i); });
+                    registers[ins] = st.output;
+                    steps.push_back(st);
+                }
+            }
+            output = nregisters - 1;
+            return true;
+        }
+
+        // Computes the elements of the output starting at start
+        void run(argument& output_arg,
+                 const std::vector<argument>& args,
+                 std::size_t start,
+                 std::size_t n) const
+        {
+            std::vector<argument> registers(nregisters);
+            std::transform(args.begin(), args.end(), registers.begin(), [&](const argument& arg) {
+                shape s{arg.get_shape().type(), {n}};
+                if(arg.get_shape().standard())
+                    return argument{s, arg.data() + start * s.type_size()};
+                // Inputs that are transposed or broadcast are copied to a contiguous block
+                auto block = argument::uninitialized(s);
+                visit_all(block, arg)([&](auto b, auto x) {
+                    for(std::size_t i = 0; i < n; i++)
+                        b[i] = x[start + i];
+                });
+                return block;
+            });
+            for(const auto& [r, lit] : literals)
+            {
+                registers[r] = argument::uninitialized(shape{lit.get_shape().type(), {n}});
+                visit_all(registers[r], lit)(
+                    [&](auto b, auto x) { std::fill(b.begin(), b.end(), x.front()); });
+            }
+            std::vector<argument> inputs;
+            for(const auto& st : steps)
+            {
+                inputs.resize(st.inputs.size());
+                std::transform(st.inputs.begin(),
+                               st.inputs.end(),
+                               inputs.begin(),
+                               [&](std::size_t i) { return registers[i]; });
+                auto s               = st.op.compute_shape(to_shapes(inputs));
+                registers[st.output] = st.op.compute(s, inputs);
+            }
+            visit_all(output_arg, registers[output])([&](auto out, auto x) {
+                for(std::size_t i = 0; i < n; i++)
+                    out[start + i] = x[i];
+            });
+        }
+    };
+
     argument compute(const shape& output_shape,
                      const std::vector<argument>& args,
                      const std::vector<module_ref>& mods,
                      const std::function<std::vector<argument>(
                          module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
     {
-        argument output{output_shape};
         auto* pm    = mods.front();
         auto pnames = pm->get_parameter_names();
         std::sort(pnames.begin(), pnames.end());
 
+        block_program bp;
+        if(not bp.build(*pm, pnames))
+            return compute_elements(output_shape, args, pm, pnames, run);
+
+        argument output{output_shape};
+        const std::size_t block_size = 4096;
+        auto elements                = output_shape.elements();
+        par_for((elements + block_size - 1) / block_size, [&](auto i) {
+            auto start = i * block_size;
+            bp.run(output, args, start, std::min(block_size, elements - start));
+        });
+        return output;
+    }
+
+    // Evaluates the submodule once for each element of the output
+    argument compute_elements(const shape& output_shape,
+                              const std::vector<argument>& args,
+                              module_ref pm,
+                              const std::vector<std::string>& pnames,
+                              const std::function<std::vector<argument>(
+                                  module_ref&, const std::unordered_map<std::string, argument>&)>&
+                                  run) const
+    {
+        argument output{output_shape};
         par_for(output_shape.elements(), [&](auto i) {
             std::unordered_map<std::string, argument> params;
 
@@ -324,8 +324,9 @@ struct pooling
                       const std::vector<std::size_t>& padding_vals,
                       Op op) const
     {
-        auto in_s    = input.get_shape();
-        auto in_lens = in_s.lens();
+        auto in_s              = input.get_shape();
+        auto in_lens           = in_s.lens();
+        const auto& in_strides = in_s.strides();
 
         // For each element of output; i.e., for each placement of pooling kernel...
         par_for(output_shape.elements(), [&](auto i) {
@@ -387,24 +388,25 @@ struct pooling
                     }
                 }
 
-                // the coordinates of this element
-                auto idx = idx_o;
-
-                // Add the kernel location idx_w and the offset win_start, for each dimension.
-                // Negative results are cast to very large unsigned integers.
-                std::transform(idx_w.begin(),
-                               idx_w.end(),
-                               win_start.begin(),
-                               idx.begin() + 2,
-                               [](auto ii, auto jj) { return ii + jj; });
-                // Check if any of coordinates are out of input tensor's range
-                if(std::mismatch(idx.begin() + 2,
-                                 idx.end(),
-                                 in_lens.begin() + 2,
-                                 in_lens.end(),
-                                 std::less<>{}) == std::make_pair(idx.end(), in_lens.end()))
+                // Add the kernel location idx_w and the offset win_start, for each dimension, to
+                // find the offset of this element in the input. Negative results are cast to
+                // very large unsigned integers.
+                std::size_t offset = idx_o[0] * in_strides[0] + idx_o[1] * in_strides[1];
+                bool inside        = true;
+                for(std::size_t axis = 0; axis < idx_w.size(); ++axis)
                 {
-                    output_val = op(output_val, input[in_s.index(idx)]);
+                    std::size_t x = idx_w[axis] + win_start[axis];
+                    // Check if the coordinate is out of input tensor's range
+                    if(x >= in_lens[axis + 2])
+                    {
+                        inside = false;
+                        break;
+                    }
+                    offset += x * in_strides[axis + 2];
+                }
+                if(inside)
+                {
+                    output_val = op(output_val, input.data()[offset]);
                 }
                 else
                 {
@@ -440,7 +442,7 @@ struct pooling
             // for dynamic GlobalPooling, there's no padding
             kernel_dims.insert(kernel_dims.end(), input_lens.begin() + 2, input_lens.end());
             output_shape = dyn_out.computed_shape;
-            result       = argument{dyn_out.computed_shape};
+            result       = argument::uninitialized(dyn_out.computed_shape);
         }
         else if((padding_mode != op::padding_mode_t::default_))
         {
@@ -462,13 +464,13 @@ struct pooling
             output_shape = compute_padded_pool_shape(
                 args[0].get_shape(), shape(type, kernel_dims), temp_padding, stride, {1, 1});
 
-            result = argument(output_shape);
+            result = argument::uninitialized(output_shape);
         }
         else // fixed/static input
         {
             kernel_dims  = this->lengths;
             output_shape = dyn_out.computed_shape;
-            result       = argument{dyn_out.computed_shape};
+            result       = argument::uninitialized(dyn_out.computed_shape);
         }
 
         // Perform the computation and populate result
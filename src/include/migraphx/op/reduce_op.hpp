@@ -195,22 +195,25 @@ struct reduce_op : op_name<Derived>
     template <class T>
     void reduce(const tensor_view<T>& input,
                 const shape& batch_shape,
-                const std::vector<int64_t>& tuned_axes,
-                const std::vector<std::size_t>& out_idx,
-                tensor_view<T>& output) const
+                const shape_runs<1>& window,
+                std::size_t offset,
+                T& output) const
     {
         using accumulator = accumulator_type<T>;
         auto& self        = static_cast<const Derived&>(*this);
-        auto data_idx     = out_idx;
         accumulator val   = self.init();
-        shape_for_each(batch_shape, [&](const auto& b_idx) {
-            this->tune_dims(tuned_axes, b_idx, data_idx);
-            accumulator x = input(data_idx.begin(), data_idx.end());
-            val           = self.op()(accumulator{self.input()(x)}, val);
+        auto n            = window.length();
+        auto stride       = window.strides()[0];
+        window.for_each([&](const auto& offsets) {
+            const auto* x = input.data() + offset + offsets[0];
+            for(std::size_t k = 0; k < n; k++)
+            {
+                accumulator y = x[k * stride];
+                val           = self.op()(accumulator{self.input()(y)}, val);
+            }
         });
 
-        output(out_idx.begin(), out_idx.end()) =
-            static_cast<const Derived&>(*this).output(batch_shape)(val);
+        output = static_cast<const Derived&>(*this).output(batch_shape)(val);
     }
 
     argument reduce(const shape& computed_shape,
@@ -221,12 +224,23 @@ struct reduce_op : op_name<Derived>
         auto arg_lens = data_arg.get_shape().lens();
         tune_dims(reduce_axes, arg_lens, batch_lens);
         shape batch_shape{computed_shape.type(), batch_lens};
-        argument result{computed_shape};
+        auto result = argument::uninitialized(computed_shape);
 
         visit_all(result, data_arg)([&](auto output, auto input) {
+            const auto& in_strides = input.get_shape().strides();
+            const auto& out_lens   = computed_shape.lens();
+            // The elements reduced into one output, relative to the first of them
+            shape_runs<1> window{{shape{computed_shape.type(), batch_lens, in_strides}}};
             par_for(computed_shape.elements(), [&](auto i) {
-                auto out_idx = computed_shape.multi(i);
-                this->reduce(input, batch_shape, reduce_axes, out_idx, output);
+                // Offset of the first reduced element in the input
+                std::size_t offset = 0;
+                std::size_t idx    = i;
+                for(std::size_t d = out_lens.size(); d > 0; d--)
+                {
+                    offset += (idx % out_lens[d - 1]) * in_strides[d - 1];
+                    idx /= out_lens[d - 1];
+                }
+                this->reduce(input, batch_shape, window, offset, output[i]);
             });
         });
 
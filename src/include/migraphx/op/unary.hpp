@@ -82,7 +82,7 @@ struct unary : op_name<Derived>
 
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        auto result = argument::uninitialized(dyn_out.computed_shape);
         result.visit([&](auto output) {
             args[0].visit([&](auto input) {
                 par_transform(input.begin(),
@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PASS_PROFILE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PASS_PROFILE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/value.hpp>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Records every pass that is run while compiling a program. Passes applied to the whole program
+ * are recorded with an empty module name and the instruction count of all the modules.
+ */
+struct MIGRAPHX_EXPORT pass_profile
+{
+    struct record
+    {
+        std::string pass;
+        std::string module;
+        double ms                       = 0;
+        std::size_t instructions_before = 0;
+        std::size_t instructions_after  = 0;
+
+        template <class Self, class F>
+        static auto reflect(Self& self, F f)
+        {
+            return pack(f(self.pass, "pass"),
+                        f(self.module, "module"),
+                        f(self.ms, "ms"),
+                        f(self.instructions_before, "instructions_before"),
+                        f(self.instructions_after, "instructions_after"));
+        }
+    };
+
+    struct total
+    {
+        std::string pass;
+        std::size_t calls = 0;
+        double ms         = 0;
+
+        template <class Self, class F>
+        static auto reflect(Self& self, F f)
+        {
+            return pack(f(self.pass, "pass"), f(self.calls, "calls"), f(self.ms, "ms"));
+        }
+    };
+
+    /// Add a record, which can be called from concurrently running passes
+    void add(record r);
+
+    /// Records in the order the passes finished
+    std::vector<record> get_records() const;
+
+    /// Time spent in each pass, from the slowest to the fastest
+    std::vector<total> get_totals() const;
+
+    /// Report with the records and the totals
+    value to_value() const;
+
+    /// Print the totals as a table
+    void print_summary(std::ostream& os) const;
+
+    private:
+    mutable std::mutex m;
+    std::vector<record> records;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PASS_PROFILE_HPP
@@ -38,6 +38,7 @@
 #include <migraphx/env.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/execution_environment.hpp>
+#include <migraphx/execution_session.hpp>
 #include <algorithm>
 #include <iostream>
 
@@ -48,6 +49,7 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_COMPILE)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_EVAL)
 
 struct program_impl;
+struct specialization_stats;
 
 struct marker;
 
@@ -84,6 +86,8 @@ struct MIGRAPHX_EXPORT program
 
     std::size_t size() const;
 
+    /// The output shapes of the main module. For a program compiled with max_specializations set
+    /// these are the dynamic shapes, since each specialization is a separate program.
     std::vector<shape> get_output_shapes() const;
 
     context& get_context() const;
@@ -100,6 +104,10 @@ struct MIGRAPHX_EXPORT program
 
     bool is_compiled() const;
 
+    /// Returns the hits, misses and compile times of the specializations compiled for the input
+    /// shapes when the program was compiled with max_specializations set
+    specialization_stats get_specialization_stats() const;
+
     void finalize();
 
     void perf_report(std::ostream& os,
@@ -111,7 +119,11 @@ struct MIGRAPHX_EXPORT program
     void mark(const parameter_map& params, marker&& m);
 
     value to_value() const;
+    /// Same as to_value but the literals are serialized by the callback
+    value to_value(const std::function<value(const literal&)>& literal_to_value) const;
     void from_value(const value& v);
+    /// Same as from_value but the literals are created by the callback from their serialized value
+    void from_value(const value& v, const std::function<literal(const value&)>& make_literal);
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -155,6 +167,7 @@ struct MIGRAPHX_EXPORT program
     void remove_unused_modules();
 
     private:
+    friend struct execution_session;
     void assign(const program& p);
     std::unique_ptr<program_impl> impl;
 };
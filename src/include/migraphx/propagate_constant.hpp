@@ -40,6 +40,7 @@ struct MIGRAPHX_EXPORT propagate_constant
 {
     std::unordered_set<std::string> skip_ops = {};
     std::string name() const { return "propagate_constant"; }
+    bool is_module_local() const { return true; }
     void apply(module& m) const;
 };
 
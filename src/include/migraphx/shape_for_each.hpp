@@ -27,6 +27,10 @@
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -37,20 +41,23 @@ inline namespace MIGRAPHX_INLINE_NS {
 template <class F>
 void shape_for_each(const migraphx::shape& s, F f)
 {
-    std::vector<std::size_t> indices(s.lens().size());
+    const auto& lens = s.lens();
+    std::vector<std::size_t> indices(lens.size());
     const auto& index_const_ref = indices;
-    shape ss{s.type(), s.lens()};
-    size_t max = ss.elements();
+    std::size_t max             = s.elements();
     for(std::size_t i = 0; i < max; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
+        // Advance the indices like an odometer instead of dividing the element index
+        if(i > 0)
+        {
+            for(std::size_t d = lens.size(); d > 0; d--)
+            {
+                assert(lens[d - 1] > 0);
+                if(++indices[d - 1] < lens[d - 1])
+                    break;
+                indices[d - 1] = 0;
+            }
+        }
         if constexpr(std::is_invocable<F, decltype(index_const_ref), decltype(i)>{})
             f(index_const_ref, i);
         else
@@ -58,6 +65,114 @@ void shape_for_each(const migraphx::shape& s, F f)
     }
 }
 
+/**
+ * Visits the elements of shapes with the same lens in order, a run of elements at a time. The
+ * dimensions that are contiguous in every shape are merged, and a run is the whole innermost
+ * merged dimension, so a standard shape is a single run. The elements of a run are `strides()`
+ * apart in each shape, starting at the element offsets passed to `for_each`.
+ */
+template <std::size_t N>
+struct shape_runs
+{
+    explicit shape_runs(const std::array<shape, N>& ss)
+    {
+        const auto& lens = ss.front().lens();
+        assert(std::all_of(ss.begin(), ss.end(), [&](const shape& s) { return s.lens() == lens; }));
+        for(std::size_t d = lens.size(); d > 0; d--)
+        {
+            auto len = lens[d - 1];
+            if(len == 0)
+            {
+                empty = true;
+                return;
+            }
+            if(len == 1)
+                continue;
+            std::array<std::size_t, N> d_strides;
+            std::transform(ss.begin(), ss.end(), d_strides.begin(), [&](const shape& s) {
+                return s.strides()[d - 1];
+            });
+            if(not dim_lens.empty() and
+               std::equal(d_strides.begin(),
+                          d_strides.end(),
+                          dim_strides.back().begin(),
+                          [&](auto outer, auto inner) { return outer == inner * dim_lens.back(); }))
+            {
+                dim_lens.back() *= len;
+                continue;
+            }
+            dim_lens.push_back(len);
+            dim_strides.push_back(d_strides);
+        }
+    }
+
+    /// Number of elements in every run
+    std::size_t length() const
+    {
+        if(empty)
+            return 0;
+        if(dim_lens.empty())
+            return 1;
+        return dim_lens.front();
+    }
+
+    /// Distance between the elements of a run in each shape
+    std::array<std::size_t, N> strides() const
+    {
+        if(dim_strides.empty())
+            return {};
+        return dim_strides.front();
+    }
+
+    /// Calls `f(offsets)` with the element offsets of the start of each run in every shape
+    template <class F>
+    void for_each(F f) const
+    {
+        if(empty)
+            return;
+        std::array<std::size_t, N> offsets{};
+        const auto& offsets_const_ref = offsets;
+        if(dim_lens.size() < 2)
+        {
+            f(offsets_const_ref);
+            return;
+        }
+        // The outer dimensions are advanced like an odometer, updating the offsets as they go
+        std::vector<std::size_t> indices(dim_lens.size());
+        for(;;)
+        {
+            f(offsets_const_ref);
+            std::size_t d = 1;
+            for(; d < dim_lens.size(); d++)
+            {
+                std::transform(offsets.begin(),
+                               offsets.end(),
+                               dim_strides[d].begin(),
+                               offsets.begin(),
+                               std::plus<>{});
+                if(++indices[d] < dim_lens[d])
+                    break;
+                indices[d] = 0;
+                std::transform(offsets.begin(),
+                               offsets.end(),
+                               dim_strides[d].begin(),
+                               offsets.begin(),
+                               [&](auto offset, auto stride) {
+                                   return offset - stride * dim_lens[d];
+                               });
+            }
+            if(d == dim_lens.size())
+                return;
+        }
+    }
+
+    private:
+    // Merged dimensions, innermost first
+    std::vector<std::size_t> dim_lens;
+    std::vector<std::array<std::size_t, N>> dim_strides;
+    bool empty = false;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -38,8 +38,11 @@ struct module;
  */
 struct MIGRAPHX_EXPORT simplify_reshapes
 {
+    /// A depth of one runs a single pass over the module, otherwise the finders run until
+    /// nothing more matches
     size_t depth = 4;
     std::string name() const { return "simplify_reshapes"; }
+    bool is_module_local() const { return true; }
     void apply(module& m) const;
 };
 
@@ -0,0 +1,75 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_SPECIALIZATION_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_SPECIALIZATION_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/compile_options.hpp>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct specialization_stats
+{
+    std::size_t hits      = 0;
+    std::size_t misses    = 0;
+    std::size_t evictions = 0;
+    /// Total time spent compiling specializations
+    double compile_ms = 0;
+    /// Longest time spent compiling a single specialization
+    double max_compile_ms = 0;
+};
+
+struct specialization_cache_impl;
+
+/**
+ * Compiles a program with dynamic input shapes for the static shapes of the inputs it is
+ * evaluated with. A specialization is compiled the first time a set of input shapes is seen, and
+ * at most `capacity` of them are kept, evicting the least recently used one. Evaluations with
+ * other shapes are not blocked while a specialization compiles, and evaluations with the same
+ * shapes wait for it.
+ */
+struct MIGRAPHX_EXPORT specialization_cache
+{
+    specialization_cache(program p, target t, compile_options options, std::size_t capacity);
+
+    std::vector<argument> eval(const parameter_map& params,
+                               execution_environment exec_env = execution_environment{}) const;
+
+    specialization_stats stats() const;
+
+    /// Returns the program with the dynamic shapes replaced by the shapes of the parameters
+    static program specialize(program p, const parameter_map& params);
+
+    private:
+    std::shared_ptr<specialization_cache_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_SPECIALIZATION_CACHE_HPP
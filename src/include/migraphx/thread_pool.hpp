@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_impl;
+
+/**
+ * A persistent pool of worker threads. Each worker owns a task queue and idle
+ * workers steal tasks from the other queues, so a dispatch only needs to
+ * enqueue work instead of creating and joining threads. The thread calling
+ * `run` participates in the work as well. Nested calls from inside a worker
+ * are executed serially on that worker.
+ */
+struct MIGRAPHX_EXPORT thread_pool
+{
+    /// Create a pool with `nthreads` workers, pinning worker `i` to cpu `i` when `pin` is set
+    thread_pool(std::size_t nthreads, bool pin = false);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool();
+
+    /// Number of worker threads, which does not include the calling thread
+    std::size_t size() const;
+
+    /// Maximum number of threads that can work on a single `run`
+    std::size_t max_concurrency() const;
+
+    /// Invoke `f(i)` for every `i` in `[0, n)` and block until all of them are finished
+    template <class F>
+    void run(std::size_t n, F f)
+    {
+        run_impl(
+            n,
+            [](void* data, std::size_t i) { (*static_cast<F*>(data))(i); },
+            std::addressof(f));
+    }
+
+    /// Process-wide pool, its size can be set with `MIGRAPHX_NUM_THREADS` and
+    /// pinning enabled with `MIGRAPHX_THREAD_AFFINITY`
+    static thread_pool& global();
+
+    private:
+    void run_impl(std::size_t n, void (*invoke)(void*, std::size_t), void* data);
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_TRACER_HPP
 #define MIGRAPHX_GUARD_RTGLIB_TRACER_HPP
 
+#include <memory>
 #include <ostream>
 #include <migraphx/functional.hpp>
 #include <migraphx/config.hpp>
@@ -31,6 +32,8 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+struct pass_profile;
+
 struct tracer
 {
     tracer() {}
@@ -49,6 +52,9 @@ struct tracer
         }
     }
 
+    /// Records the passes that are run when set
+    std::shared_ptr<pass_profile> profile = nullptr;
+
     private:
     std::ostream* os = nullptr;
 };
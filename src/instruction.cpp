@@ -94,7 +94,7 @@ bool operator==(const instruction& i, instruction_ref ref)
     return std::addressof(i) == std::addressof(*ref);
 }
 
-bool instruction::valid(instruction_ref start, bool check_order) const
+bool instruction::valid(instruction_ref, bool check_order) const
 {
     return valid() && std::all_of(arguments.begin(), arguments.end(), [&](instruction_ref i) {
                auto self = std::find(i->outputs().begin(), i->outputs().end(), *this);
@@ -102,7 +102,7 @@ bool instruction::valid(instruction_ref start, bool check_order) const
                if(check_order)
                {
                    // check arguments for this instruction before this instruction
-                   ret = ret and (std::distance(start, i) < std::distance(start, *self));
+                   ret = ret and i->ordinal < ordinal;
                }
                return ret;
            });
@@ -446,6 +446,11 @@ instruction_ref instruction::get_output_alias(instruction_ref ins, bool shallow)
     return get_output_alias(ins->inputs().at(i));
 }
 
+bool instruction::writes_output_alias(instruction_ref ins)
+{
+    return ins->get_operator().output_alias(to_shapes(ins->inputs())) > 0;
+}
+
 void instruction::set_normalized(bool value) { normalized = value; }
 
 bool instruction::is_normalized() const { return normalized; }
@@ -26,14 +26,93 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
+#include <migraphx/serialize.hpp>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// A saved msgpack program is laid out as:
+//
+//   header | literal data, each aligned to mxr_alignment | msgpack of the program value
+//
+// The literals in the program value only store an offset into the data section, so loading can
+// map the file and have the literals point at the mapped pages directly. This layout was
+// introduced with program file version 8. Files without the header are loaded as plain msgpack.
+constexpr const char mxr_magic[8]     = {'M', 'I', 'G', 'X', 'M', 'X', 'R', '\0'};
+constexpr std::uint32_t mxr_version   = 1;
+constexpr std::size_t mxr_alignment   = 64;
+constexpr std::size_t mxr_header_size = 64;
+
+struct mxr_header
+{
+    char magic[8]                 = {};
+    std::uint32_t version         = mxr_version;
+    std::uint32_t alignment       = mxr_alignment;
+    std::uint64_t data_offset     = 0;
+    std::uint64_t data_size       = 0;
+    std::uint64_t metadata_offset = 0;
+    std::uint64_t metadata_size   = 0;
+};
+static_assert(sizeof(mxr_header) <= mxr_header_size, "Header is too large");
+
+static std::size_t mxr_padded_size(std::size_t n)
+{
+    return (n + mxr_alignment - 1) / mxr_alignment * mxr_alignment;
+}
+
+static bool has_mxr_header(const char* buffer, std::size_t size)
+{
+    return size >= mxr_header_size and std::memcmp(buffer, mxr_magic, sizeof(mxr_magic)) == 0;
+}
+
+static mxr_header read_mxr_header(const char* buffer, std::size_t size)
+{
+    mxr_header header;
+    std::memcpy(&header, buffer, sizeof(mxr_header));
+    if(header.version != mxr_version)
+        MIGRAPHX_THROW("Unsupported MXR file layout version: " + std::to_string(header.version));
+    // Each value is checked against the size on its own, so a corrupt header can not wrap around
+    if(header.data_offset > size or header.data_size > size - header.data_offset or
+       header.metadata_offset > size or header.metadata_size > size - header.metadata_offset)
+        MIGRAPHX_THROW("MXR file is truncated");
+    if(header.data_offset % mxr_alignment != 0)
+        MIGRAPHX_THROW("MXR data section is not aligned: " + std::to_string(header.data_offset));
+    return header;
+}
+
+// When owner is set it holds the buffer, and the literals share it instead of copying
+static program
+load_mxr(const char* buffer, std::size_t size, const std::shared_ptr<char>& owner = nullptr)
+{
+    auto header = read_mxr_header(buffer, size);
+    auto v      = from_msgpack(buffer + header.metadata_offset, header.metadata_size);
+    program p;
+    p.from_value(v, [&](const value& lv) {
+        if(not lv.contains("offset"))
+            return migraphx::from_value<literal>(lv);
+        auto s      = migraphx::from_value<shape>(lv.at("shape"));
+        auto offset = lv.at("offset").to<std::size_t>();
+        if(offset > header.data_size or s.bytes() > header.data_size - offset)
+            MIGRAPHX_THROW("Literal is outside of the MXR data section");
+        offset += header.data_offset;
+        if(owner == nullptr)
+            return literal{s, buffer + offset};
+        return literal{s, std::shared_ptr<char>(owner, owner.get() + offset)};
+    });
+    return p;
+}
+
 program load(const std::string& filename, const file_options& options)
 {
-    return load_buffer(read_buffer(filename), options);
+    if(options.format != "msgpack")
+        return load_buffer(read_buffer(filename), options);
+    auto [buffer, size] = map_buffer(filename);
+    if(has_mxr_header(buffer.get(), size))
+        return load_mxr(buffer.get(), size, buffer);
+    return load_buffer(buffer.get(), size, options);
 }
 program load_buffer(const std::vector<char>& buffer, const file_options& options)
 {
@@ -44,6 +123,8 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     program p;
     if(options.format == "msgpack")
     {
+        if(has_mxr_header(buffer, size))
+            return load_mxr(buffer, size);
         p.from_value(from_msgpack(buffer, size));
     }
     else if(options.format == "json")
@@ -57,11 +138,6 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     return p;
 }
 
-void save(const program& p, const std::string& filename, const file_options& options)
-{
-    write_buffer(filename, save_buffer(p, options));
-}
-
 // MIOpen doesn't support serializing fusion plans with Find-2.0 APIs
 void print_miopen_warning(const program& p)
 {
@@ -80,18 +156,81 @@ void print_miopen_warning(const program& p)
     }
 }
 
+// Literal data is written straight from the literals, so only the program value without any
+// literal data is held in memory while saving
+static void save_mxr(const program& p, std::ostream& os)
+{
+    mxr_header header;
+    std::memcpy(header.magic, mxr_magic, sizeof(mxr_magic));
+    header.data_offset = mxr_header_size;
+    std::vector<literal> literals;
+    value v = p.to_value([&](const literal& l) {
+        if(l.empty())
+            return migraphx::to_value(l);
+        value result;
+        result["shape"]  = migraphx::to_value(l.get_shape());
+        result["offset"] = header.data_size;
+        header.data_size += mxr_padded_size(l.get_shape().bytes());
+        literals.push_back(l);
+        return result;
+    });
+    auto metadata          = to_msgpack(v);
+    header.metadata_offset = header.data_offset + header.data_size;
+    header.metadata_size   = metadata.size();
+
+    const char padding[mxr_alignment] = {};
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(padding, mxr_header_size - sizeof(header));
+    for(const auto& l : literals)
+    {
+        auto n = l.get_shape().bytes();
+        os.write(l.data(), n);
+        os.write(padding, mxr_padded_size(n) - n);
+    }
+    os.write(metadata.data(), metadata.size());
+}
+
+void save(const program& p, const std::string& filename, const file_options& options)
+{
+    if(options.format != "msgpack")
+    {
+        write_buffer(filename, save_buffer(p, options));
+        return;
+    }
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    if(not os.is_open())
+        MIGRAPHX_THROW("Failure opening file: " + filename);
+    save(p, os, options);
+    if(not os)
+        MIGRAPHX_THROW("Error writing file: " + filename);
+}
+
+void save(const program& p, std::ostream& os, const file_options& options)
+{
+    if(options.format == "msgpack")
+    {
+        print_miopen_warning(p);
+        save_mxr(p, os);
+        return;
+    }
+    auto buffer = save_buffer(p, options);
+    os.write(buffer.data(), buffer.size());
+}
+
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
-    value v = p.to_value();
     print_miopen_warning(p);
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        std::ostringstream ss;
+        save_mxr(p, ss);
+        auto s = ss.str();
+        buffer = std::vector<char>(s.begin(), s.end());
     }
     else if(options.format == "json")
     {
-        std::string s = to_json_string(v);
+        std::string s = to_json_string(p.to_value());
         buffer        = std::vector<char>(s.begin(), s.end());
     }
     else
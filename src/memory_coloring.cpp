@@ -33,13 +33,17 @@
 #include <migraphx/stringutils.hpp>
 #include <unordered_set>
 #include <unordered_map>
+#include <limits>
 #include <map>
+#include <queue>
 #include <set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DEBUG_MEMORY_COLORING);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MEMORY_COLORING);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_MEMORY_PLANNER_INTERVALS);
 
 using instruction_set     = std::unordered_set<instruction_ref>;
 using instruction_set_map = std::unordered_map<instruction_ref, instruction_set>;
@@ -297,11 +301,11 @@ static std::size_t find_max_alignment(const module& m, const std::string& alloca
     return alignment;
 }
 
-void memory_coloring::apply(module& m) const
+static allocation_segment
+color_allocations(const module& m, const std::string& allocation_op, std::size_t alignment)
 {
-    const std::size_t alignment = find_max_alignment(m, allocation_op);
-    auto conflict_table         = build_conflict_table(m, allocation_op);
-    auto as                     = allocation_segment::build(m, conflict_table, alignment);
+    auto conflict_table = build_conflict_table(m, allocation_op);
+    auto as             = allocation_segment::build(m, conflict_table, alignment);
 
     // All allocations should have a segment
     assert(std::all_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
@@ -335,6 +339,134 @@ void memory_coloring::apply(module& m) const
             }
         }
     }
+    return as;
+}
+
+struct live_interval
+{
+    instruction_ref ins;
+    std::size_t start;
+    std::size_t end;
+};
+
+// The live interval of an allocation goes from the allocation to the last use of the allocation
+// or any of its aliases. This is the same liveness that is used to build the conflict table, but
+// it only tracks the last use instead of the set of live variables.
+static std::vector<live_interval> build_live_intervals(const module& m,
+                                                       const std::string& allocation_op)
+{
+    std::vector<live_interval> result;
+    auto implicit_deps = m.calc_implicit_deps();
+    std::unordered_map<instruction_ref, std::size_t> last_use;
+    std::size_t i = std::distance(m.begin(), m.end());
+    auto rp       = reverse(m);
+    for(auto rins : iterator_for(rp)) // NOLINT
+    {
+        auto ins = std::prev(rins.base());
+        i--;
+        auto add_uses = [&](const auto& inputs) {
+            for(auto input : inputs)
+            {
+                auto alias = instruction::get_output_alias(input);
+                if(not m.has_instruction(alias))
+                    continue;
+                last_use.emplace(alias, i);
+            }
+        };
+        add_uses(ins->inputs());
+        add_uses(implicit_deps[ins]);
+        if(ins->name() != allocation_op or ins->get_shape().bytes() == 0)
+            continue;
+        auto it = last_use.find(ins);
+        result.push_back({ins, i, it == last_use.end() ? i : it->second});
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+// Sweeps over the allocations in the order they become live. The segments of the allocations
+// that are no longer live are popped from a heap ordered by the end of their live interval, and
+// each new allocation is put in the smallest gap between the live segments that it fits in, or
+// else after the last live segment.
+static allocation_segment
+sweep_allocations(const module& m, const std::string& allocation_op, std::size_t alignment)
+{
+    using segment = allocation_segment::segment;
+    allocation_segment as{};
+    auto intervals = build_live_intervals(m, allocation_op);
+    // Live segments ordered by offset
+    std::set<segment> live;
+    // Live segments with the end of their live interval, ordered so the first to expire is on top
+    using expiry = std::pair<std::size_t, segment>;
+    std::priority_queue<expiry, std::vector<expiry>, std::greater<>> expiring;
+    for(const auto& interval : intervals)
+    {
+        while(not expiring.empty() and expiring.top().first < interval.start)
+        {
+            live.erase(expiring.top().second);
+            expiring.pop();
+        }
+        auto n            = 1 + (interval.ins->get_shape().bytes() - 1) / alignment;
+        auto best         = std::numeric_limits<std::size_t>::max();
+        std::size_t pos   = 0;
+        std::size_t top   = 0;
+        std::size_t start = 0;
+        bool found        = false;
+        for(const auto& seg : live)
+        {
+            if(seg.first > pos)
+            {
+                auto gap = seg.first - pos;
+                if(gap >= n and gap < best)
+                {
+                    best  = gap;
+                    start = pos;
+                    found = true;
+                }
+            }
+            pos = std::max(pos, seg.second);
+            top = pos;
+        }
+        if(not found)
+            start = top;
+        auto s = segment{start, start + n};
+        assert(std::none_of(
+            live.begin(), live.end(), [&](const auto& seg) { return is_overlap(seg, s); }));
+        live.insert(s);
+        expiring.emplace(interval.end, s);
+        as.add_segment(interval.ins, s);
+    }
+
+    if(enabled(MIGRAPHX_DEBUG_MEMORY_COLORING{}))
+    {
+        for(const auto& interval : intervals)
+        {
+            auto s = as.ins2segment.at(interval.ins);
+            std::cout << "[" << interval.start << ", " << interval.end << "] " << s.first << ", "
+                      << s.second << ": ";
+            m.debug_print(interval.ins);
+        }
+    }
+    return as;
+}
+
+void memory_coloring::apply(module& m) const
+{
+    const std::size_t alignment = find_max_alignment(m, allocation_op);
+    const bool intervals        = use_intervals or enabled(MIGRAPHX_MEMORY_PLANNER_INTERVALS{});
+    auto as                     = intervals ? sweep_allocations(m, allocation_op, alignment)
+                                            : color_allocations(m, allocation_op, alignment);
+
+    if(enabled(MIGRAPHX_TRACE_MEMORY_COLORING{}))
+    {
+        auto other = intervals ? color_allocations(m, allocation_op, alignment)
+                               : sweep_allocations(m, allocation_op, alignment);
+        auto coloring_size = (intervals ? other.max() : as.max()) * alignment;
+        auto interval_size = (intervals ? as.max() : other.max()) * alignment;
+        std::cout << "memory_coloring: " << (intervals ? "intervals" : "coloring")
+                  << ", scratch with coloring: " << coloring_size
+                  << " bytes, scratch with intervals: " << interval_size << " bytes" << std::endl;
+    }
 
     // Total memory
     std::size_t n = as.max() * alignment;
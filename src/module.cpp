@@ -23,6 +23,7 @@
  */
 #include <iterator>
 #include <migraphx/algorithm.hpp>
+#include <migraphx/arena.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
@@ -41,6 +42,7 @@
 #include <sstream>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <set>
 #include <utility>
 #include <unordered_set>
@@ -52,18 +54,124 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
 
 struct module_impl
 {
-    // A list is used to keep references to an instruction stable
-    std::list<instruction> instructions;
-    std::unordered_set<instruction*> instruction_set;
+    // The instructions are allocated from the arena, and the list keeps references to an
+    // instruction stable
+    arena instruction_arena;
+    instruction_list instructions{arena_allocator<instruction>{&instruction_arena}};
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
+    // Changed by every edit of the module, see module::version
+    std::uint64_t version = next_version();
+
+    // The versions are drawn from a counter shared by every module, so a version is never reused,
+    // even by a module that is assigned from another one
+    static std::uint64_t next_version()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    void modified() { version = next_version(); }
 
     bool contains(instruction_ref ins) const
     {
         if(is_end(ins, instructions.end()))
             return false;
-        return instruction_set.count(std::addressof(*ins)) > 0;
+        return instruction_arena.contains(std::addressof(*ins));
+    }
+
+    // The ordinals are kept in the range [0, max_ordinal] and appended instructions are spaced
+    // ordinal_step apart
+    static constexpr std::uint64_t max_ordinal  = std::uint64_t{1} << 62u;
+    static constexpr std::uint64_t ordinal_step = std::uint64_t{1} << 32u;
+
+    // Labels the instruction at its position, between the ordinals of its neighbours. When the
+    // neighbours leave no room, the instructions around it are relabeled.
+    void assign_ordinal(instruction_ref ins)
+    {
+        auto next = std::next(ins);
+        if(ins == instructions.begin() and next == instructions.end())
+        {
+            ins->ordinal = ordinal_step;
+            return;
+        }
+        std::uint64_t first = ins == instructions.begin() ? 0 : std::prev(ins)->ordinal + 1;
+        if(next == instructions.end())
+        {
+            if(max_ordinal - first >= ordinal_step)
+            {
+                ins->ordinal = first + ordinal_step - 1;
+                return;
+            }
+        }
+        else if(first < next->ordinal)
+        {
+            ins->ordinal = first + (next->ordinal - first) / 2;
+            return;
+        }
+        relabel(ins);
+    }
+
+    // Spreads out the ordinals in the smallest aligned range around ins whose density is below a
+    // threshold that gets stricter as the range grows. This is the order maintenance scheme from
+    // Bender et al. "Two Simplified Algorithms for Maintaining Order in a List", which takes
+    // amortized logarithmic time per insertion.
+    void relabel(instruction_ref ins)
+    {
+        std::uint64_t base = ins == instructions.begin() ? 0 : std::prev(ins)->ordinal;
+        double threshold   = 1.0;
+        for(std::uint64_t size = 2; size <= max_ordinal; size *= 2)
+        {
+            threshold /= 1.3;
+            auto limit         = static_cast<double>(size) * threshold;
+            std::uint64_t low  = base & ~(size - 1);
+            std::uint64_t high = low + size;
+            auto first         = ins;
+            auto last          = std::next(ins);
+            std::size_t n      = 1;
+            while(first != instructions.begin() and std::prev(first)->ordinal >= low and n < limit)
+            {
+                --first;
+                n++;
+            }
+            while(last != instructions.end() and last->ordinal < high and n < limit)
+            {
+                ++last;
+                n++;
+            }
+            if(n >= limit)
+                continue;
+            spread_ordinals(first, last, n, low, size);
+            return;
+        }
+        spread_ordinals(
+            instructions.begin(), instructions.end(), instructions.size(), 0, max_ordinal);
+    }
+
+    void spread_ordinals(instruction_ref first,
+                         instruction_ref last,
+                         std::size_t n,
+                         std::uint64_t low,
+                         std::uint64_t size)
+    {
+        std::uint64_t gap = size / (n + 1);
+        std::uint64_t x   = low;
+        assert(gap > 0);
+        for(auto ins = first; ins != last; ++ins)
+        {
+            x += gap;
+            ins->ordinal = x;
+        }
+    }
+
+    bool precedes(instruction_ref x, instruction_ref y) const
+    {
+        if(is_end(y, instructions.end()))
+            return not is_end(x, instructions.end());
+        if(is_end(x, instructions.end()))
+            return false;
+        return x->ordinal < y->ordinal;
     }
 
     template <class... Ts>
@@ -71,7 +179,8 @@ struct module_impl
     {
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
-        instruction_set.insert(std::addressof(*r));
+        assign_ordinal(r);
+        modified();
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -79,11 +188,27 @@ struct module_impl
         return emplace(pos, ins);
     }
 
+    // Replaces the instruction in place, keeping the label of its position
+    void assign(instruction_ref ins, instruction x)
+    {
+        auto ordinal = ins->ordinal;
+        *ins         = std::move(x);
+        ins->ordinal = ordinal;
+        modified();
+    }
+
+    void move(instruction_ref src, instruction_ref dst)
+    {
+        instructions.splice(dst, instructions, src);
+        assign_ordinal(src);
+        modified();
+    }
+
     void clear()
     {
         instructions.clear();
-        instruction_set.clear();
         nparams = 0;
+        modified();
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -104,13 +229,13 @@ struct module_impl
 
     instruction_ref erase(instruction_ref pos)
     {
-        instruction_set.erase(std::addressof(*pos));
+        modified();
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
-        std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        modified();
         return instructions.erase(start, last);
     }
 };
@@ -142,6 +267,8 @@ void module::set_name(const std::string& name) { impl->name = name; }
 bool module::bypass() const { return impl->bypass; }
 void module::set_bypass(bool b) { impl->bypass = b; }
 
+std::uint64_t module::version() const { return impl->version; }
+
 void module::assign(const module& m)
 {
     // copy the impl
@@ -324,6 +451,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->modified();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -337,6 +465,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->modified();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -359,6 +488,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->modified();
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -404,7 +534,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
 {
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
-    impl->instructions.splice(dst, impl->instructions, src);
+    impl->move(src, dst);
     return src;
 }
 
@@ -412,7 +542,7 @@ instruction_ref module::move_instructions(instruction_ref src, instruction_ref d
 {
     for(auto ins : src->inputs())
     {
-        if(not contains(this->impl->instructions, ins))
+        if(not impl->contains(ins))
             continue;
         this->move_instructions(ins, dst);
     }
@@ -536,6 +666,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->modified();
     assert(last->valid(begin()));
 
     return last;
@@ -615,7 +746,7 @@ void module::rename_parameter(instruction_ref ins, const std::string& name)
     auto op      = any_cast<builtin::param>(ins->get_operator());
     op.parameter = name;
     auto outputs = ins->outputs();
-    *ins         = instruction{op, ins->get_shape(), {}};
+    impl->assign(ins, instruction{op, ins->get_shape(), {}});
     for(auto output : outputs)
         ins->add_output(output);
 }
@@ -636,6 +767,13 @@ std::unordered_map<std::string, shape> module::get_parameter_shapes() const
 
 bool module::has_instruction(instruction_ref ins) const { return impl->contains(ins); }
 
+bool module::precedes(instruction_ref x, instruction_ref y) const
+{
+    assert(has_instruction(x) or is_end(x, this->end()));
+    assert(has_instruction(y) or is_end(y, this->end()));
+    return impl->precedes(x, y);
+}
+
 std::size_t module::size() const { return impl->instructions.size(); }
 instruction_ref module::begin() const { return impl->instructions.begin(); }
 instruction_ref module::end() const { return impl->instructions.end(); }
@@ -1279,7 +1417,7 @@ module& module::sort()
         }
         for(auto child : ins_inputs)
         {
-            if(not contains(this->impl->instructions, child))
+            if(not impl->contains(child))
             {
                 continue;
             }
@@ -32,6 +32,8 @@
 #include <onnx.pb.h>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -107,6 +109,15 @@ struct onnx_parser
 
     std::unordered_map<std::string, op_func> ops;
 
+    // The external data files are mapped once, and the literals created from them keep the
+    // mapping alive
+    struct external_data_files
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::pair<std::shared_ptr<char>, std::size_t>> buffers;
+    };
+    std::shared_ptr<external_data_files> external_files = std::make_shared<external_data_files>();
+
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
 
@@ -120,6 +131,8 @@ struct onnx_parser
     parse_graph(module* mod, const onnx::GraphProto& graph, bool inlining = false);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
+    std::pair<std::shared_ptr<char>, std::size_t>
+    map_external_data(const std::string& data_file) const;
     shape parse_type(const onnx::TypeProto& t) const;
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
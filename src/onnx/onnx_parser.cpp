@@ -35,6 +35,7 @@
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
 #include <migraphx/float8.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/env.hpp>
 #include <onnx.pb.h>
 
@@ -324,12 +325,17 @@ std::unordered_map<std::string, instruction_ref>
 parse_intializer(const onnx_parser& parser, module* mod, const onnx::GraphProto& graph)
 {
     std::unordered_map<std::string, instruction_ref> mod_insts;
-    for(auto&& f : graph.initializer())
+    // Decoding the tensors is independent, so it is done in parallel before adding the literals
+    std::vector<literal> literals(graph.initializer_size());
+    par_for(literals.size(),
+            [&](std::size_t i) { literals[i] = parser.parse_tensor(graph.initializer(i)); });
+    for(std::size_t i = 0; i < literals.size(); i++)
     {
+        const auto& f = graph.initializer(i);
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
             std::cout << "initializer: " << f.name() << std::endl;
         // backup instructions in parent mod
-        mod_insts[f.name()] = mod->add_literal(parser.parse_tensor(f));
+        mod_insts[f.name()] = mod->add_literal(std::move(literals[i]));
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
             mod->debug_print(mod_insts[f.name()]);
     }
@@ -493,6 +499,16 @@ literal onnx_parser::parse_value(const onnx::AttributeProto& attr) const
     MIGRAPHX_THROW("PARSE_VALUE: Invalid attribute type " + std::to_string(attr.type()));
 }
 
+std::pair<std::shared_ptr<char>, std::size_t>
+onnx_parser::map_external_data(const std::string& data_file) const
+{
+    std::lock_guard<std::mutex> lock(external_files->mutex);
+    auto it = external_files->buffers.find(data_file);
+    if(it == external_files->buffers.end())
+        it = external_files->buffers.emplace(data_file, map_buffer(path / data_file)).first;
+    return it->second;
+}
+
 literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
 {
     std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
@@ -514,9 +530,19 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
         {
             nbytes = std::stoul(t.external_data().at(2).value());
         }
-        auto raw_buffer = read_buffer(path / data_file, offset, nbytes);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        return create_literal(type, dims, s.data());
+        auto [buffer, size] = map_external_data(data_file);
+        // Checked without adding the offset and length, since their sum can overflow
+        if(offset > size or nbytes > size - offset or nbytes < tensor_shape.bytes())
+            MIGRAPHX_THROW("PARSE_TENSOR: invalid external data for tensor " + t.name() +
+                           " in file " + data_file);
+        // The literal uses the mapped pages directly when the data is aligned for its type,
+        // otherwise it is copied
+        if(tensor_shape.elements() > 0 and offset % tensor_shape.type_size() == 0)
+        {
+            shape s = dims.empty() ? shape{type} : tensor_shape;
+            return literal{s, std::shared_ptr<char>(buffer, buffer.get() + offset)};
+        }
+        return create_literal(type, dims, buffer.get() + offset);
     }
     if(t.has_raw_data())
     {
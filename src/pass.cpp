@@ -31,6 +31,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct id_pass
 {
     std::string name() const { return "id"; }
+    bool is_module_local() const { return true; }
     void apply(const module&) const {}
 };
 
@@ -22,7 +22,9 @@
  * THE SOFTWARE.
  */
 #include <migraphx/program.hpp>
+#include <migraphx/algorithm.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/target.hpp>
@@ -30,9 +32,13 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/time.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/simple_par_for.hpp>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 
 namespace migraphx {
@@ -40,6 +46,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_PASSES);
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_PASSES);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_PARALLEL_PASSES);
 
 void validate_pass(module& mod, const pass& p, tracer trace)
 {
@@ -58,13 +65,42 @@ void validate_pass(module& mod, const pass& p, tracer trace)
     trace();
 #endif
 }
+static std::size_t count_instructions(const program& prog)
+{
+    auto mods = prog.get_modules();
+    return transform_accumulate(mods.begin(),
+                                mods.end(),
+                                std::size_t{0},
+                                std::plus<>{},
+                                [](const module* m) { return m->size(); });
+}
+
 void run_pass(program& prog, const pass& p, tracer trace)
 {
     trace("Pass: ", p.name());
-    p.apply(prog);
+    if(trace.profile != nullptr)
+    {
+        using milliseconds = std::chrono::duration<double, std::milli>;
+        auto before        = count_instructions(prog);
+        auto ms            = time<milliseconds>([&] { p.apply(prog); });
+        trace.profile->add({p.name(), "", ms, before, count_instructions(prog)});
+    }
+    else
+    {
+        p.apply(prog);
+    }
     trace(prog);
 }
 
+static tracer get_pass_tracer(tracer trace)
+{
+    if(not enabled(MIGRAPHX_TRACE_PASSES{}))
+        return trace;
+    tracer result{std::cout};
+    result.profile = trace.profile;
+    return result;
+}
+
 struct module_pm : module_pass_manager
 {
     module* mod           = nullptr;
@@ -72,6 +108,7 @@ struct module_pm : module_pass_manager
     tracer* t             = nullptr;
     module* common_parent = nullptr;
     program* prog         = nullptr;
+    bool module_local     = false;
 
     module_pm(module* pmod = nullptr, tracer* pt = nullptr) : mod(pmod), t(pt) {}
 
@@ -96,12 +133,16 @@ struct module_pm : module_pass_manager
     virtual module* create_module(const std::string& name) override
     {
         assert(prog);
+        if(module_local)
+            MIGRAPHX_THROW("Module local pass cannot create module: " + name);
         return prog->create_module(name);
     }
 
     virtual module* create_module(const std::string& name, module m) override
     {
         assert(prog);
+        if(module_local)
+            MIGRAPHX_THROW("Module local pass cannot create module: " + name);
         return prog->create_module(name, std::move(m));
     }
 
@@ -120,11 +161,15 @@ struct module_pm : module_pass_manager
         trace("Pass: ", p.name());
         assert(mod);
         assert(mod->validate() == mod->end());
-        if(enabled(MIGRAPHX_TIME_PASSES{}))
+        if(t->profile != nullptr or enabled(MIGRAPHX_TIME_PASSES{}))
         {
             using milliseconds = std::chrono::duration<double, std::milli>;
+            auto before        = mod->size();
             auto ms            = time<milliseconds>([&] { p.apply(*this); });
-            std::cout << p.name() << ": " << ms << "ms\n";
+            if(enabled(MIGRAPHX_TIME_PASSES{}))
+                std::cout << p.name() << ": " << ms << "ms\n";
+            if(t->profile != nullptr)
+                t->profile->add({p.name(), mod->name(), ms, before, mod->size()});
         }
         else
         {
@@ -137,45 +182,133 @@ struct module_pm : module_pass_manager
 
 module& get_module(module_pass_manager& mpm) { return mpm.get_module(); }
 
-void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& passes, tracer trace)
+// The order the modules are visited in, along with the common parent of each module. Submodules
+// are always visited before their parents. Modules with the same height in the module tree never
+// depend on each other, so each height is grouped together.
+struct module_schedule
 {
-    if(enabled(MIGRAPHX_TRACE_PASSES{}))
-        trace = tracer{std::cout};
-    std::unordered_set<module_ref> visited;
-    for(const auto& p : passes)
+    std::vector<module_ref> modules;
+    std::unordered_map<module_ref, module_ref> common_parents;
+    std::vector<std::vector<module_ref>> levels;
+    std::size_t nmodules = 0;
+
+    module_schedule(program& prog, module_ref root_mod)
     {
-        auto tree                        = prog.get_module_tree();
+        nmodules                         = prog.get_modules().size();
         std::vector<module_ref> sub_mods = root_mod->get_sub_modules();
         sub_mods.insert(sub_mods.begin(), root_mod);
-        visited.clear();
+        std::unordered_set<module_ref> visited;
         for(const auto& mod : reverse(sub_mods))
         {
             if(mod->bypass())
                 continue;
             if(not visited.insert(mod).second)
                 continue;
-            module_pm mpm{mod, root_mod, &trace};
-            mpm.prog      = &prog;
+            modules.push_back(mod);
+        }
+
+        auto tree = prog.get_module_tree();
+        for(auto mod : modules)
+        {
             auto parents  = range(tree.equal_range(mod));
             auto nparents = distance(parents);
             if(nparents == 0)
-                mpm.common_parent = nullptr;
+                common_parents[mod] = nullptr;
             else if(nparents == 1)
-                mpm.common_parent = parents.begin()->second;
+                common_parents[mod] = parents.begin()->second;
             else
                 // Just set common parent to main module when there is muliple parents for now
                 // TODO: Compute the common parent
-                mpm.common_parent = prog.get_main_module();
+                common_parents[mod] = prog.get_main_module();
+        }
+
+        std::unordered_map<module_ref, std::size_t> heights;
+        auto height = fix<std::size_t>([&](auto self, module_ref mod) -> std::size_t {
+            auto it = heights.find(mod);
+            if(it != heights.end())
+                return it->second;
+            std::size_t h = 0;
+            for(auto smod : mod->get_sub_modules(true))
+                h = std::max(h, self(smod) + 1);
+            heights[mod] = h;
+            return h;
+        });
+        for(auto mod : modules)
+        {
+            auto h = height(mod);
+            if(h >= levels.size())
+                levels.resize(h + 1);
+            levels[h].push_back(mod);
+        }
+    }
+
+    // Module local passes can remove modules from the program but never add any
+    bool is_stale(program& prog, const pass& p) const
+    {
+        return not p.is_module_local() or prog.get_modules().size() != nmodules;
+    }
+};
+
+// A module that only uses its own instructions does not share any instructions with other
+// modules, so a module local pass can modify it while it is modifying other modules
+static bool is_independent(const module& m)
+{
+    return std::all_of(m.begin(), m.end(), [&](const instruction& ins) {
+        return std::all_of(ins.inputs().begin(), ins.inputs().end(), [&](instruction_ref input) {
+            return m.has_instruction(input);
+        });
+    });
+}
+
+void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& passes, tracer trace)
+{
+    trace = get_pass_tracer(trace);
+    // Output from concurrent passes would be interleaved
+    const bool parallel = not trace.enabled() and not enabled(MIGRAPHX_TIME_PASSES{}) and
+                          not enabled(MIGRAPHX_DISABLE_PARALLEL_PASSES{});
+    std::unique_ptr<module_schedule> schedule;
+    for(const auto& p : passes)
+    {
+        if(schedule == nullptr)
+            schedule = std::make_unique<module_schedule>(prog, root_mod);
+        auto run_module_pass = [&](module_ref mod) {
+            module_pm mpm{mod, root_mod, &trace};
+            mpm.prog          = &prog;
+            mpm.common_parent = schedule->common_parents.at(mod);
+            mpm.module_local  = p.is_module_local();
             mpm.run_pass(p);
+        };
+        if(parallel and p.is_module_local())
+        {
+            for(const auto& level : schedule->levels)
+            {
+                std::vector<module_ref> independent;
+                for(auto mod : level)
+                {
+                    if(is_independent(*mod))
+                        independent.push_back(mod);
+                    else
+                        run_module_pass(mod);
+                }
+                simple_par_for(independent.size(), 1, [&](std::size_t i) {
+                    run_module_pass(independent[i]);
+                });
+            }
+        }
+        else
+        {
+            for(auto mod : schedule->modules)
+                run_module_pass(mod);
         }
         run_pass(prog, p, trace);
+        if(schedule->is_stale(prog, p))
+            schedule = nullptr;
     }
 }
 
 void run_passes(module& mod, const std::vector<pass>& passes, tracer trace)
 {
-    if(enabled(MIGRAPHX_TRACE_PASSES{}))
-        trace = tracer{std::cout};
+    trace = get_pass_tracer(trace);
     for(const auto& p : passes)
     {
         module_pm{&mod, &mod, &trace}.run_pass(p);
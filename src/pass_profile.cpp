@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+void pass_profile::add(record r)
+{
+    std::lock_guard<std::mutex> guard(m);
+    records.push_back(std::move(r));
+}
+
+std::vector<pass_profile::record> pass_profile::get_records() const
+{
+    std::lock_guard<std::mutex> guard(m);
+    return records;
+}
+
+std::vector<pass_profile::total> pass_profile::get_totals() const
+{
+    std::vector<total> result;
+    std::unordered_map<std::string, std::size_t> index;
+    for(const auto& r : get_records())
+    {
+        auto it = index.emplace(r.pass, result.size()).first;
+        if(it->second == result.size())
+            result.push_back({r.pass});
+        auto& t = result[it->second];
+        t.calls++;
+        t.ms += r.ms;
+    }
+    std::stable_sort(
+        result.begin(), result.end(), [](const auto& x, const auto& y) { return x.ms > y.ms; });
+    return result;
+}
+
+value pass_profile::to_value() const
+{
+    return {{"records", migraphx::to_value(get_records())},
+            {"totals", migraphx::to_value(get_totals())}};
+}
+
+void pass_profile::print_summary(std::ostream& os) const
+{
+    auto totals = get_totals();
+    double sum  = 0;
+    for(const auto& t : totals)
+        sum += t.ms;
+    os << std::left << std::setw(40) << "Pass" << std::right << std::setw(8) << "Calls"
+       << std::setw(14) << "Time(ms)" << std::setw(10) << "Percent" << std::endl;
+    for(const auto& t : totals)
+    {
+        os << std::left << std::setw(40) << t.pass << std::right << std::setw(8) << t.calls
+           << std::setw(14) << t.ms << std::setw(9) << (sum > 0 ? 100.0 * t.ms / sum : 0.0)
+           << "%" << std::endl;
+    }
+    os << std::left << std::setw(40) << "Total" << std::right << std::setw(8) << "" << std::setw(14)
+       << sum << std::endl;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -24,6 +24,7 @@
 #include <migraphx/version.h>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/specialization_cache.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/identity.hpp>
@@ -35,6 +36,7 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/iterator.hpp>
+#include <migraphx/liveness.hpp>
 #include <migraphx/algorithm.hpp>
 #include <migraphx/output_iterator.hpp>
 #include <migraphx/make_op.hpp>
@@ -68,12 +70,248 @@ struct mark_instruction_target
     }
 };
 
+using operation_map = std::unordered_map<instruction_ref, operation>;
+
+// The results of eval share the buffers of the literals. A literal that is returned, directly or
+// through a view, or that an operator writes into, is copied on each eval instead, so neither the
+// caller nor the operator can change the constants of the program.
+static std::unordered_set<instruction_ref> copied_literals(const module& m)
+{
+    std::unordered_set<instruction_ref> result;
+    auto add = [&](instruction_ref ins) {
+        auto alias = instruction::get_output_alias(ins);
+        if(alias->name() == "@literal")
+            result.insert(alias);
+    };
+    if(m.begin() == m.end())
+        return result;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "@return")
+            std::for_each(ins->inputs().begin(), ins->inputs().end(), add);
+        else if(instruction::writes_output_alias(ins))
+            add(ins);
+    }
+    auto last = std::prev(m.end());
+    if(last->name() != "@return")
+        add(last);
+    return result;
+}
+
+// A flat form of the main module that is built once the program is finalized, so eval can run
+// over the instructions without looking up each result in a hash map. Each instruction has a slot
+// for its result, and the slots of the literals share the buffers of the literals. A slot is
+// released after its last use, so only the live results are kept during eval. The plan records
+// the version of the module it was built from, and is only used while the module is unchanged.
+// The plan is not modified by eval, so the execution sessions share the plan of the program, and
+// only pass the operators they finalized for themselves.
+struct execution_plan
+{
+    struct step
+    {
+        operation op;
+        shape output_shape;
+        std::vector<std::size_t> inputs;
+        // The slots that are not used after this step
+        std::vector<std::size_t> release;
+        std::size_t output    = 0;
+        std::size_t target_id = 0;
+        bool context_free     = false;
+        // Execution sessions use their own copy of the operator
+        bool session_state = false;
+    };
+
+    struct parameter
+    {
+        std::string name;
+        std::size_t slot;
+        shape s;
+    };
+
+    std::vector<argument> slots;
+    // The slots of the literals that are copied on each eval
+    std::vector<std::size_t> copied_slots;
+    std::vector<parameter> parameters;
+    std::vector<step> steps;
+    std::vector<std::size_t> outputs;
+    // The instructions of the steps with session state, in the order of the steps
+    std::vector<instruction_ref> session_instructions;
+    std::size_t max_inputs = 0;
+    std::uint64_t version  = 0;
+
+    // Returns nullptr for modules with submodules, since they are evaluated with the results of
+    // their parent module
+    static std::shared_ptr<execution_plan> build(const module& m)
+    {
+        if(std::any_of(m.begin(), m.end(), [](const instruction& ins) {
+               return not ins.module_inputs().empty();
+           }))
+            return nullptr;
+        auto result     = std::make_shared<execution_plan>();
+        result->version = m.version();
+        std::unordered_map<instruction_ref, std::size_t> slot_map;
+        std::unordered_map<instruction_ref, std::vector<instruction_ref>> releases;
+        last_uses(m, [&](auto ins, const auto& inputs) { releases[ins] = inputs; });
+        auto copied = copied_literals(m);
+        for(auto ins : iterator_for(m))
+        {
+            auto slot = slot_map.size();
+            slot_map.emplace(ins, slot);
+            result->slots.emplace_back();
+            const auto& name = ins->name();
+            if(name == "@literal")
+            {
+                result->slots.back() = ins->get_literal().share_argument();
+                if(contains(copied, ins))
+                    result->copied_slots.push_back(slot);
+            }
+            else if(name == "@param")
+            {
+                auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
+                result->parameters.push_back({param_name, slot, ins->get_shape()});
+            }
+            else if(name == "@outline")
+            {
+                result->slots.back() = argument{ins->get_shape(), nullptr};
+            }
+            else if(name == "@return")
+            {
+                result->slots.pop_back();
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(result->outputs),
+                               [&](instruction_ref i) { return slot_map.at(i); });
+                return result;
+            }
+            else
+            {
+                step st;
+                st.op            = ins->normalized_operator();
+                st.output_shape  = ins->get_shape();
+                st.output        = slot;
+                st.target_id     = ins->get_target_id();
+                st.context_free  = st.op.is_context_free();
+                st.session_state = st.op.attributes().get("session_state", false);
+                if(st.session_state)
+                    result->session_instructions.push_back(ins);
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(st.inputs),
+                               [&](instruction_ref i) { return slot_map.at(i); });
+                std::transform(releases[ins].begin(),
+                               releases[ins].end(),
+                               std::back_inserter(st.release),
+                               [&](instruction_ref i) { return slot_map.at(i); });
+                result->max_inputs = std::max(result->max_inputs, st.inputs.size());
+                result->steps.push_back(std::move(st));
+            }
+        }
+        if(not result->slots.empty())
+            result->outputs = {result->slots.size() - 1};
+        return result;
+    }
+
+    // The session operators replace the operators of the steps with session state, in order
+    std::vector<argument> eval(std::vector<context>& ctx,
+                               const std::unordered_map<std::string, argument>& params,
+                               const std::vector<operation>& session_ops = {}) const
+    {
+        auto results = slots;
+        for(auto i : copied_slots)
+            results[i] = results[i].copy();
+        for(const auto& param : parameters)
+        {
+            auto it = params.find(param.name);
+            if(it == params.end())
+                MIGRAPHX_THROW("Parameter not found: " + param.name);
+            // TODO: may want to check correct number of dimensions and/or was within bounds
+            if(not param.s.any_of_dynamic() and it->second.get_shape() != param.s)
+            {
+                MIGRAPHX_THROW("Incorrect shape {" + to_string(it->second.get_shape()) +
+                               "} for parameter: " + param.name +
+                               " should be: " + to_string(param.s));
+            }
+            results[param.slot] = it->second;
+        }
+        std::vector<argument> values;
+        values.reserve(max_inputs);
+        std::size_t session_op = 0;
+        for(const auto& st : steps)
+        {
+            const operation* op = &st.op;
+            if(st.session_state)
+            {
+                if(not session_ops.empty())
+                    op = &session_ops[session_op];
+                session_op++;
+            }
+            values.resize(st.inputs.size());
+            std::transform(st.inputs.begin(),
+                           st.inputs.end(),
+                           values.begin(),
+                           [&](std::size_t i) { return results[i]; });
+            auto& r = results[st.output];
+            if(st.context_free)
+            {
+                r = op->compute(st.output_shape, values);
+            }
+            else
+            {
+                if(st.target_id >= ctx.size())
+                    MIGRAPHX_THROW("No context available for " + op->name());
+                r = op->compute(ctx[st.target_id], st.output_shape, values);
+            }
+            assert(st.output_shape.any_of_dynamic() or r.get_shape() == st.output_shape);
+            values.clear();
+            for(auto i : st.release)
+                results[i] = argument{};
+        }
+        std::vector<argument> out;
+        out.reserve(outputs.size());
+        std::transform(outputs.begin(),
+                       outputs.end(),
+                       std::back_inserter(out),
+                       [&](std::size_t i) { return results[i]; });
+        return out;
+    }
+};
+
+// The results that each instruction releases after it is evaluated, so generic_eval only keeps the
+// live results, and the literals it copies. They are computed once for each module when the
+// program is finalized instead of on every evaluation, and are only used while the module has the
+// version they were computed for.
+struct module_releases
+{
+    std::uint64_t version = 0;
+    std::unordered_map<instruction_ref, std::vector<instruction_ref>> releases;
+    std::unordered_set<instruction_ref> copied;
+
+    explicit module_releases(const module& m) : version(m.version()), copied(copied_literals(m))
+    {
+        last_uses(m, [&](auto ins, const auto& inputs) { releases[ins] = inputs; });
+    }
+};
+
+using releases_map = std::unordered_map<const module*, std::shared_ptr<const module_releases>>;
+
+static releases_map compute_releases(const program& p)
+{
+    releases_map result;
+    for(const auto* mod : p.get_modules())
+        result.emplace(mod, std::make_shared<module_releases>(*mod));
+    return result;
+}
+
 struct program_impl
 {
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     std::vector<context> contexts;
     std::vector<target> targets;
+    std::shared_ptr<execution_plan> plan;
+    releases_map releases;
+    // Set when the program is compiled for the shapes of its inputs when it is evaluated
+    std::shared_ptr<specialization_cache> specializations;
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -127,6 +365,11 @@ void program::assign(const program& p)
         for(auto ins : iterator_for(mp.second))
             instruction::replace_refs(ins, ins_map, mod_map);
     }
+
+    if(impl->plan != nullptr)
+        impl->plan = execution_plan::build(*this->get_main_module());
+    if(not impl->releases.empty())
+        impl->releases = compute_releases(*this);
 }
 
 shape program::get_parameter_shape(std::string name) const
@@ -218,6 +461,13 @@ target_assignments program::get_target_assignments(const std::vector<target>& ta
 
 bool program::is_compiled() const { return not this->impl->contexts.empty(); }
 
+specialization_stats program::get_specialization_stats() const
+{
+    if(this->impl->specializations == nullptr)
+        return {};
+    return this->impl->specializations->stats();
+}
+
 void program::compile(const std::vector<target>& targets, std::vector<compile_options> compile_opts)
 {
     // Gather all the target roots
@@ -282,7 +532,9 @@ void program::compile(const std::vector<target>& targets, std::vector<compile_op
             auto passes = root_target.get_passes(this->impl->contexts[root_target_id],
                                                  compile_opts[root_target_id]);
             passes.push_back(mark_instruction_target{static_cast<size_t>(root_target_id)});
-            run_passes(*this, current_mod, passes, trace);
+            auto target_trace    = trace;
+            target_trace.profile = compile_opts[root_target_id].profile;
+            run_passes(*this, current_mod, passes, target_trace);
 
             auto invalid = current_mod->validate();
             if(invalid != current_mod->end())
@@ -307,11 +559,27 @@ void program::compile(const target& t, compile_options options)
 {
     // todo: combine with multi-target compile method
     assert(not this->is_compiled());
+    const auto* mm = this->get_main_module();
+    if(options.max_specializations > 0 and
+       std::any_of(mm->begin(), mm->end(), [](const instruction& ins) {
+           return ins.name() == "@param" and ins.get_shape().dynamic();
+       }))
+    {
+        auto capacity               = options.max_specializations;
+        options.max_specializations = 0;
+        this->impl->specializations =
+            std::make_shared<specialization_cache>(*this, t, options, capacity);
+        this->impl->targets  = {t};
+        this->impl->contexts = {t.get_context()};
+        return;
+    }
     this->impl->targets  = {t};
     this->impl->contexts = {t.get_context()};
 
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
         options.trace = tracer{std::cout};
+    if(options.profile != nullptr)
+        options.trace.profile = options.profile;
 
     options.trace(*this);
     options.trace();
@@ -336,12 +604,16 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->contexts);
     }
+    this->impl->plan     = execution_plan::build(*this->get_main_module());
+    this->impl->releases = compute_releases(*this);
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->contexts);
+    this->impl->plan     = execution_plan::build(*mm);
+    this->impl->releases = compute_releases(*this);
 }
 
 template <class T>
@@ -426,15 +698,66 @@ void preview_argument(std::ostream& os, const argument& a)
         });
 }
 
+// The results of evaluating a module. The results of the parent modules are looked up through the
+// parent, so the submodules share them instead of copying them.
+struct module_results
+{
+    std::unordered_map<instruction_ref, argument> results;
+    const module_results* parent = nullptr;
+    // Operators used instead of the ones in the modules
+    const operation_map* ops     = nullptr;
+    const releases_map* releases = nullptr;
+
+    std::shared_ptr<const module_releases> get_releases(const module& m) const
+    {
+        if(releases != nullptr)
+        {
+            auto it = releases->find(&m);
+            if(it != releases->end() and it->second->version == m.version())
+                return it->second;
+        }
+        return std::make_shared<module_releases>(m);
+    }
+
+    operation get_operator(instruction_ref ins) const
+    {
+        if(ops != nullptr)
+        {
+            auto it = ops->find(ins);
+            if(it != ops->end())
+                return it->second;
+        }
+        return ins->normalized_operator();
+    }
+
+    const argument& at(instruction_ref ins) const
+    {
+        auto it = results.find(ins);
+        if(it != results.end())
+            return it->second;
+        assert(parent != nullptr);
+        return parent->at(ins);
+    }
+};
+
 template <class F>
 std::vector<argument> generic_eval(const module* mod,
                                    std::vector<context>& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   std::unordered_map<instruction_ref, argument> results,
-                                   F trace)
+                                   const std::unordered_map<std::string, argument>& params,
+                                   const module_results* parent,
+                                   F trace,
+                                   const operation_map* ops     = nullptr,
+                                   const releases_map* releases = nullptr)
 {
     assert(mod->validate() == mod->end());
-    results.reserve(mod->size() * 2);
+    module_results mr;
+    mr.parent     = parent;
+    mr.ops        = parent == nullptr ? ops : parent->ops;
+    mr.releases   = parent == nullptr ? releases : parent->releases;
+    auto& results = mr.results;
+    results.reserve(mod->size());
+    // A result is released after its last use, so only the live results are kept
+    auto mod_releases = mr.get_releases(*mod);
     std::vector<argument> values;
     values.reserve(16);
     for(auto ins : iterator_for(*mod))
@@ -443,16 +766,22 @@ std::vector<argument> generic_eval(const module* mod,
         const auto& name = ins->name();
         if(name == "@literal")
         {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
+            results.emplace(ins, trace(ins, [&] {
+                const auto& lit = ins->get_literal();
+                if(contains(mod_releases->copied, ins))
+                    return lit.get_argument();
+                return lit.share_argument();
+            }));
         }
         else if(name == "@param")
         {
             results.emplace(
                 ins, trace(ins, [&] {
                     auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
+                    auto it         = params.find(param_name);
+                    if(it == params.end())
                         MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
+                    const auto& param = it->second;
                     // TODO: may want to check correct number of dimensions and/or was within bounds
                     if(not ins->get_shape().any_of_dynamic() and
                        param.get_shape() != ins->get_shape())
@@ -474,30 +803,26 @@ std::vector<argument> generic_eval(const module* mod,
             std::transform(ins->inputs().begin(),
                            ins->inputs().end(),
                            std::back_inserter(prog_outputs),
-                           [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
-                           });
+                           [&](instruction_ref i) { return mr.at(i); });
 
             return prog_outputs;
         }
         else
         {
             values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           values.begin(),
+                           [&](instruction_ref i) { return mr.at(i); });
             const auto& mod_args = ins->module_inputs();
             auto module_eval     = [&](module_ref smod,
                                    const std::unordered_map<std::string, argument>& inputs) {
-                return generic_eval(smod, ctx, inputs, results, trace);
+                return generic_eval(smod, ctx, inputs, &mr, trace);
             };
 
             results.emplace(
                 ins, trace(ins, [&] {
-                    auto op = ins->normalized_operator();
+                    auto op = mr.get_operator(ins);
                     if(op.is_context_free())
                         return op.compute(ins->get_shape(), values, mod_args, module_eval);
                     if(ins->get_target_id() >= ctx.size())
@@ -505,26 +830,37 @@ std::vector<argument> generic_eval(const module* mod,
                     return op.compute(
                         ctx[ins->get_target_id()], ins->get_shape(), values, mod_args, module_eval);
                 }));
+            values.clear();
         }
         assert(results.find(ins) != results.end());
         assert(ins->get_shape().any_of_dynamic() or
                results.at(ins).get_shape() == ins->get_shape());
+        auto it = mod_releases->releases.find(ins);
+        if(it != mod_releases->releases.end())
+        {
+            for(auto i : it->second)
+                results.erase(i);
+        }
     }
     return {results.at(std::prev(mod->end()))};
 }
 
 template <class F>
 std::vector<argument> generic_eval(const program& p,
+                                   const releases_map& releases,
                                    std::vector<context>& ctx,
                                    std::unordered_map<std::string, argument> params,
                                    F trace)
 {
     const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, trace);
+    return generic_eval(mm, ctx, params, nullptr, trace, nullptr, &releases);
 }
 
 std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
 {
+    if(this->impl->specializations != nullptr)
+        return this->impl->specializations->eval(params, exec_env);
+
     auto& contexts = this->impl->contexts;
 
     auto trace_level = value_of(MIGRAPHX_TRACE_EVAL{});
@@ -545,54 +881,65 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
             instruction::print(ss, x, ins_names);
             ins_out[x] = ss.str();
         });
-        ret = generic_eval(*this, contexts, std::move(params), [&](instruction_ref ins, auto f) {
-            const auto& ctx = contexts[ins->get_target_id()];
-            ctx.finish();
-            std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
-            timer t{};
-            auto result = f();
-            double t1   = t.record<milliseconds>();
-            ctx.finish();
-            double t2 = t.record<milliseconds>();
-            std::cout << "Time: " << t1 << "ms, " << t2 << "ms" << std::endl;
-            if(trace_level > 1 and ins->name().front() != '@' and ins->name() != "load" and
-               not result.empty())
-            {
-                migraphx::argument buffer;
-                try
+        ret = generic_eval(
+            *this, impl->releases, contexts, std::move(params), [&](instruction_ref ins, auto f) {
+                const auto& ctx = contexts[ins->get_target_id()];
+                ctx.finish();
+                std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
+                timer t{};
+                auto result = f();
+                double t1   = t.record<milliseconds>();
+                ctx.finish();
+                double t2 = t.record<milliseconds>();
+                std::cout << "Time: " << t1 << "ms, " << t2 << "ms" << std::endl;
+                if(trace_level > 1 and ins->name().front() != '@' and ins->name() != "load" and
+                   not result.empty())
                 {
-                    const target& tgt = this->impl->targets.at(ins->get_target_id());
-                    buffer            = tgt.copy_from(result);
-                }
-                catch(const migraphx::exception&)
-                {
-                    // instruction was run on host then no need to copy buffer from target
-                    buffer = result;
-                }
-                catch(...)
-                {
-                    MIGRAPHX_THROW("MIGraphX program execution with MIGRAPHX_TRACE_EVAL failed.\n");
-                }
-                if(trace_level == 2)
-                {
-                    std::cout << "Output has " << to_string_range(classify_argument(buffer))
-                              << std::endl;
-                    std::cout << "Output: ";
-                    preview_argument(std::cout, buffer);
-                    std::cout << std::endl;
-                    print_statistics(std::cout, buffer);
-                }
-                else
-                {
-                    std::cout << "Output: " << buffer << std::endl;
+                    migraphx::argument buffer;
+                    try
+                    {
+                        const target& tgt = this->impl->targets.at(ins->get_target_id());
+                        buffer            = tgt.copy_from(result);
+                    }
+                    catch(const migraphx::exception&)
+                    {
+                        // instruction was run on host then no need to copy buffer from target
+                        buffer = result;
+                    }
+                    catch(...)
+                    {
+                        MIGRAPHX_THROW(
+                            "MIGraphX program execution with MIGRAPHX_TRACE_EVAL failed.\n");
+                    }
+                    if(trace_level == 2)
+                    {
+                        std::cout << "Output has " << to_string_range(classify_argument(buffer))
+                                  << std::endl;
+                        std::cout << "Output: ";
+                        preview_argument(std::cout, buffer);
+                        std::cout << std::endl;
+                        print_statistics(std::cout, buffer);
+                    }
+                    else
+                    {
+                        std::cout << "Output: " << buffer << std::endl;
+                    }
                 }
-            }
-            return result;
-        });
+                return result;
+            });
+    }
+    // Edits made through a module pointer that was taken before the program was finalized are not
+    // in the plan, so the module is evaluated directly in that case
+    else if(this->impl->plan != nullptr and
+            this->impl->plan->version == this->get_main_module()->version())
+    {
+        ret = this->impl->plan->eval(contexts, params);
     }
     else
     {
-        ret = generic_eval(*this, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
+        ret = generic_eval(*this, impl->releases, contexts, std::move(params), [&](auto&&, auto f) {
+            return f();
+        });
     }
 
     if(exec_env.async)
@@ -604,6 +951,96 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
     return ret;
 }
 
+struct execution_session_impl
+{
+    const program* prog = nullptr;
+    std::vector<context> contexts;
+    // The operators that are finalized again for the session
+    operation_map ops;
+    // The plan of the program is shared, and the session operators are passed in the order of its
+    // session steps
+    std::shared_ptr<const execution_plan> plan;
+    std::vector<operation> plan_ops;
+};
+
+execution_session::execution_session(const program& p)
+    : impl(std::make_shared<execution_session_impl>())
+{
+    if(not p.is_compiled())
+        MIGRAPHX_THROW("Execution session requires a compiled program");
+    if(p.impl->specializations != nullptr)
+        MIGRAPHX_THROW(
+            "Execution session does not support programs compiled for each input shape");
+    impl->prog = &p;
+    std::transform(p.impl->targets.begin(),
+                   p.impl->targets.end(),
+                   std::back_inserter(impl->contexts),
+                   [](const target& t) { return t.get_context(); });
+    // Operators that set up state in the context or own scratch memory when they are finalized
+    // are copied and finalized with the contexts of the session, the rest are shared
+    for(const auto* mod : p.get_modules())
+    {
+        for(auto ins : iterator_for(*mod))
+        {
+            if(not ins->get_operator().attributes().get("session_state", false))
+                continue;
+            auto op = ins->normalized_operator();
+            op.finalize(impl->contexts[ins->get_target_id()],
+                        ins->get_shape(),
+                        to_shapes(ins->inputs()));
+            impl->ops.emplace(ins, std::move(op));
+        }
+    }
+    const auto* mm = p.get_main_module();
+    if(p.impl->plan != nullptr and p.impl->plan->version == mm->version())
+    {
+        impl->plan = p.impl->plan;
+        std::transform(impl->plan->session_instructions.begin(),
+                       impl->plan->session_instructions.end(),
+                       std::back_inserter(impl->plan_ops),
+                       [&](instruction_ref ins) { return impl->ops.at(ins); });
+    }
+}
+
+std::vector<argument> execution_session::eval(parameter_map params,
+                                              execution_environment exec_env) const
+{
+    auto& contexts = impl->contexts;
+    std::vector<argument> ret;
+    if(exec_env.async)
+    {
+        assert(contexts.size() == 1);
+        contexts.front().wait_for(exec_env.queue);
+    }
+    if(impl->plan != nullptr)
+    {
+        ret = impl->plan->eval(contexts, params, impl->plan_ops);
+    }
+    else
+    {
+        ret = generic_eval(
+            impl->prog->get_main_module(),
+            contexts,
+            params,
+            nullptr,
+            [&](auto&&, auto f) { return f(); },
+            &impl->ops,
+            &impl->prog->impl->releases);
+    }
+    if(exec_env.async)
+    {
+        assert(contexts.size() == 1);
+        contexts.front().finish_on(exec_env.queue);
+    }
+    return ret;
+}
+
+void execution_session::finish() const
+{
+    for(const auto& ctx : impl->contexts)
+        ctx.finish();
+}
+
 void program::finish() const
 {
     for(const auto& ctx : this->impl->contexts)
@@ -621,16 +1058,35 @@ std::string get_migraphx_version()
 /*
 program file version is for the data structure or format of the MXR file. Version should be bumped
 if any changes occur to the format of the MXR file.
+
+Version 8 writes msgpack programs with a header and the literal data in a separate aligned section
+before the msgpack of the program (see load_save.cpp). Builds reading version 7 can not parse these
+files, and version 7 files have to be regenerated.
 */
-const int program_file_version = 7;
+const int program_file_version = 8;
 
 value program::to_value() const
+{
+    return this->to_value([](const literal& l) { return migraphx::to_value(l); });
+}
+
+value program::to_value(const std::function<value(const literal&)>& literal_to_value) const
 {
     value result;
     result["version"]          = program_file_version;
     result["migraphx_version"] = get_migraphx_version();
-    result["targets"]          = migraphx::to_value(this->impl->targets);
-    result["contexts"]         = migraphx::to_value(this->impl->contexts);
+    // The modules of a program compiled for each input shape are not compiled, so it is saved
+    // without the targets and loaded as an uncompiled program
+    if(this->impl->specializations == nullptr)
+    {
+        result["targets"]  = migraphx::to_value(this->impl->targets);
+        result["contexts"] = migraphx::to_value(this->impl->contexts);
+    }
+    else
+    {
+        result["targets"]  = value::array{};
+        result["contexts"] = value::array{};
+    }
     value module_vals          = value::object{};
     std::unordered_map<instruction_ref, std::string> names;
     for(auto& mod : this->get_modules())
@@ -646,7 +1102,7 @@ value program::to_value() const
                 node["shape"]      = migraphx::to_value(ins->get_shape());
                 node["normalized"] = ins->is_normalized();
                 if(ins->name() == "@literal")
-                    node["literal"] = migraphx::to_value(ins->get_literal());
+                    node["literal"] = literal_to_value(ins->get_literal());
                 node["operator"] = ins->get_operator().to_value();
                 std::vector<std::string> inputs;
                 std::transform(ins->inputs().begin(),
@@ -684,7 +1140,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& make_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -702,8 +1159,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output =
-                mod->insert_literal(mod->end(), migraphx::from_value<literal>(node.at("literal")));
+            output = mod->insert_literal(mod->end(), make_literal(node.at("literal")));
         }
         else
         {
@@ -728,7 +1184,7 @@ static void mod_from_val(module_ref mod,
 
                 for(const auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, make_literal);
                 }
             }
 
@@ -751,6 +1207,11 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& lv) { return migraphx::from_value<literal>(lv); });
+}
+
+void program::from_value(const value& v, const std::function<literal(const value&)>& make_literal)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -794,7 +1255,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, make_literal);
 
     // Finalize a compiled model
     if(not this->impl->contexts.empty())
@@ -842,7 +1303,7 @@ void program::mark(const parameter_map& params, marker&& m)
     this->finish();
     // Start marking
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+    generic_eval(*this, impl->releases, ctx, params, [&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
@@ -872,7 +1333,7 @@ void program::perf_report(
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
     // Fill the map
-    generic_eval(*this, ctx, params, [&](auto ins, auto) {
+    generic_eval(*this, impl->releases, ctx, params, [&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{ins->get_shape(), nullptr};
     });
@@ -880,7 +1341,7 @@ void program::perf_report(
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+        generic_eval(*this, impl->releases, ctx, params, [&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -904,6 +1365,8 @@ void program::perf_report(
     double overhead_time          = common_average(overhead_vec);
     double overhead_percent       = overhead_time * 100.0 / total_time;
     double total_instruction_time = 0.0;
+    double reorder_time           = 0.0;
+    std::size_t nreorders         = 0;
     std::unordered_map<std::string, double> op_times;
     std::unordered_map<std::string, std::size_t> op_n;
     for(auto&& p : ins_vec)
@@ -912,6 +1375,12 @@ void program::perf_report(
         op_times[perf_group(p.first, detailed)] += avg;
         total_instruction_time += avg;
         op_n[perf_group(p.first, detailed)]++;
+        // Ops that only change the memory layout of their input
+        if(p.first->get_operator().attributes().get("reorder", false))
+        {
+            reorder_time += avg;
+            nreorders++;
+        }
     }
     double calculate_overhead_time    = total_time - total_instruction_time;
     double calculate_overhead_percent = calculate_overhead_time * 100.0 / total_time;
@@ -953,6 +1422,8 @@ void program::perf_report(
     os << "Rate: " << rate * batch << " inferences/sec" << std::endl;
     os << "Total time: " << total_time << "ms" << std::endl;
     os << "Total instructions time: " << total_instruction_time << "ms" << std::endl;
+    if(nreorders > 0)
+        os << "Reorders: " << nreorders << ", " << reorder_time << "ms" << std::endl;
     os << "Overhead time: " << overhead_time << "ms"
        << ", " << calculate_overhead_time << "ms" << std::endl;
     os << "Overhead: " << std::round(overhead_percent) << "%"
@@ -1056,7 +1527,7 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->contexts;
-    generic_eval(*this, ctx, std::move(params), [](auto ins, auto&&...) {
+    generic_eval(*this, impl->releases, ctx, std::move(params), [](auto ins, auto&&...) {
         return argument{ins->get_shape(), nullptr};
     });
 }
@@ -47,21 +47,123 @@ bool skip_propagate(instruction_ref ins)
     return false;
 }
 
-bool is_const_ins(instruction_ref ins, std::unordered_set<std::string> skip_ops)
+// Move the result into a literal without copying when it is a whole standard buffer that the
+// instruction computed, the literal keeps the argument alive. A view into one of its inputs is
+// copied, so the literal doesn't keep the rest of the input alive or share its memory.
+static literal to_literal(instruction_ref ins, const argument& a)
 {
-    return ins->can_eval() and not skip_propagate(ins) and
-           skip_ops.find(ins->name()) == skip_ops.end();
+    if(instruction::get_output_alias(ins) != ins or not a.get_shape().standard())
+        return {a.get_shape(), a.data()};
+    return {a.get_shape(), std::shared_ptr<char>(a.data(), [a](char*) {})};
+}
+
+// Evaluates each instruction once, in topological order. Instructions at the same depth do not
+// depend on each other so they are evaluated in parallel. Intermediate results are released as
+// soon as all of their consumers have been evaluated.
+static std::vector<argument> eval_constants(const std::vector<instruction_ref>& outputs)
+{
+    std::unordered_map<instruction_ref, std::size_t> depths;
+    std::unordered_map<instruction_ref, std::size_t> uses;
+    std::vector<std::vector<instruction_ref>> levels;
+    auto visit = fix<std::size_t>([&](auto self, instruction_ref ins) -> std::size_t {
+        auto it = depths.find(ins);
+        if(it != depths.end())
+            return it->second;
+        std::size_t depth = 0;
+        if(ins->name() != "@literal")
+        {
+            for(auto input : ins->inputs())
+            {
+                depth = std::max(depth, self(input) + 1);
+                uses[input]++;
+            }
+        }
+        if(levels.size() <= depth)
+            levels.resize(depth + 1);
+        levels[depth].push_back(ins);
+        depths[ins] = depth;
+        return depth;
+    });
+    std::for_each(outputs.begin(), outputs.end(), visit);
+
+    // Insert every result up front so the map is not modified while evaluating in parallel
+    std::unordered_map<instruction_ref, argument> results;
+    for(const auto& p : depths)
+        results[p.first];
+    std::unordered_set<instruction_ref> keep(outputs.begin(), outputs.end());
+    for(const auto& level : levels)
+    {
+        simple_par_for(level.size(), 1, [&](const auto i) {
+            auto ins = level[i];
+            if(ins->name() == "@literal")
+            {
+                // An operator that writes into the literal gets a copy, so the literal is unchanged
+                auto written = std::any_of(ins->outputs().begin(),
+                                           ins->outputs().end(),
+                                           [&](instruction_ref output) {
+                                               return instruction::writes_output_alias(output) and
+                                                      instruction::get_output_alias(output, true) ==
+                                                          ins;
+                                           });
+                results.at(ins) = written ? ins->get_literal().get_argument()
+                                          : ins->get_literal().share_argument();
+                return;
+            }
+            std::vector<argument> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           [&](auto input) { return results.at(input); });
+            results.at(ins) = ins->normalized_operator().compute(ins->get_shape(), args);
+        });
+        for(auto ins : level)
+        {
+            if(ins->name() == "@literal")
+                continue;
+            for(auto input : ins->inputs())
+            {
+                if(--uses[input] == 0 and not contains(keep, input))
+                    results.at(input) = {};
+            }
+        }
+    }
+    std::vector<argument> output_results;
+    std::transform(outputs.begin(),
+                   outputs.end(),
+                   std::back_inserter(output_results),
+                   [&](auto ins) { return results.at(ins); });
+    return output_results;
 }
 
 void propagate_constant::apply(module& m) const
 {
+    // Whether each instruction can be evaluated, computed once in order instead of walking the
+    // inputs of every instruction with instruction::can_eval
+    std::unordered_map<instruction_ref, bool> evaluable;
+    auto can_eval = [&](instruction_ref ins) {
+        auto it = evaluable.find(ins);
+        if(it != evaluable.end())
+            return it->second;
+        // Inputs from a parent module
+        return ins->can_eval();
+    };
+    for(auto i : iterator_for(m))
+    {
+        evaluable[i] = i->name() == "@literal" or
+                       (is_context_free(i->get_operator()) and
+                        std::all_of(i->inputs().begin(), i->inputs().end(), can_eval));
+    }
+    auto is_const_ins = [&](instruction_ref ins) {
+        return can_eval(ins) and not skip_propagate(ins) and not contains(skip_ops, ins->name());
+    };
+
     std::unordered_set<instruction_ref> const_instrs;
     auto last = std::prev(m.end());
 
     // Find instructions that can be evaluated to a literal
     for(auto i : iterator_for(m))
     {
-        const bool is_const = is_const_ins(i, skip_ops);
+        const bool is_const = is_const_ins(i);
         if(is_const and i != last)
             continue;
 
@@ -75,17 +177,14 @@ void propagate_constant::apply(module& m) const
                          i->inputs().end(),
                          std::inserter(const_instrs, const_instrs.begin()),
                          [&](const instruction_ref ins) {
-                             return is_const_ins(ins, skip_ops) and ins->name() != "@literal";
+                             return is_const_ins(ins) and ins->name() != "@literal";
                          });
         }
     }
 
-    // Compute literals in parallel
+    // Compute literals, sharing the evaluation of common subgraphs
     std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
-    std::vector<argument> literals(const_instrs_vec.size());
-    simple_par_for(const_instrs_vec.size(), 1, [&](const auto i) {
-        literals[i] = const_instrs_vec[i]->eval();
-    });
+    std::vector<argument> literals = eval_constants(const_instrs_vec);
 
     // Replace instructions in m
     for(size_t i = 0; i < const_instrs_vec.size(); i++)
@@ -106,7 +205,7 @@ void propagate_constant::apply(module& m) const
                 m.debug_print(inss);
             }
             assert(literals[i].get_shape() == const_instrs_vec[i]->get_shape());
-            auto l = m.add_literal(literals[i].get_shape(), literals[i].data());
+            auto l = m.add_literal(to_literal(const_instrs_vec[i], literals[i]));
             m.replace_instruction(const_instrs_vec[i], l);
         }
     }
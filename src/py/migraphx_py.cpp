@@ -43,6 +43,7 @@
 #include <migraphx/op/common.hpp>
 #include <migraphx/float8.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
 #endif
@@ -379,17 +380,24 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
                const migraphx::target& t,
                bool offload_copy,
                bool fast_math,
-               bool exhaustive_tune) {
+               bool exhaustive_tune,
+               bool profile_passes) -> py::object {
                 migraphx::compile_options options;
                 options.offload_copy    = offload_copy;
                 options.fast_math       = fast_math;
                 options.exhaustive_tune = exhaustive_tune;
+                if(profile_passes)
+                    options.profile = std::make_shared<migraphx::pass_profile>();
                 p.compile(t, options);
+                if(options.profile == nullptr)
+                    return py::none();
+                return py::str(migraphx::to_json_string(options.profile->to_value()));
             },
             py::arg("t"),
             py::arg("offload_copy")    = true,
             py::arg("fast_math")       = true,
-            py::arg("exhaustive_tune") = false)
+            py::arg("exhaustive_tune") = false,
+            py::arg("profile_passes")  = false)
         .def("get_main_module", [](const migraphx::program& p) { return p.get_main_module(); })
         .def(
             "create_module",
@@ -430,6 +438,22 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
+    py::class_<migraphx::execution_session>(m, "execution_session")
+        .def(py::init<const migraphx::program&>(), py::arg("p"), py::keep_alive<1, 2>())
+        .def("run", [](const migraphx::execution_session& s, py::dict params) {
+            migraphx::parameter_map pm;
+            for(auto x : params)
+            {
+                std::string key      = x.first.cast<std::string>();
+                py::buffer b         = x.second.cast<py::buffer>();
+                py::buffer_info info = b.request();
+                pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+            }
+            // Other threads can run their own sessions while this one is evaluated
+            py::gil_scoped_release release;
+            return s.eval(pm);
+        });
+
     py::class_<migraphx::operation> op(m, "op");
     op.def(py::init([](const std::string& name, py::kwargs kwargs) {
           migraphx::value v = migraphx::value::object{};
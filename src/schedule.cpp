@@ -453,7 +453,7 @@ struct stream_info
             ins2index[ins] = index_total++;
 
         std::vector<conflict_table_type> thread_conflict_tables(
-            std::thread::hardware_concurrency());
+            thread_pool::global().max_concurrency());
         std::vector<instruction_ref> index_to_ins;
         index_to_ins.reserve(concur_ins.size());
         std::transform(concur_ins.begin(),
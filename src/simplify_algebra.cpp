@@ -146,11 +146,10 @@ struct find_mul_slice_conv
         if(slice_op.axes.front() != 1)
             return;
 
-        auto slice_idx = std::distance(conv_ins, slice_ins);
         if(std::any_of(conv_ins->outputs().begin(), conv_ins->outputs().end(), [&](auto i) {
                if(i == slice_ins)
                    return false;
-               if(std::distance(conv_ins, i) < slice_idx)
+               if(m.precedes(i, slice_ins))
                    return true;
                auto sop = any_cast<op::slice>(i->get_operator());
                if(sop.axes != slice_op.axes)
@@ -1631,38 +1630,33 @@ struct find_split_transpose
 
 void simplify_algebra::apply(module& m) const
 {
-    // Run simplifications multiple times
-    for(int i = 0; i < 8; i++)
-    {
-        match::find_matches(m,
-                            find_inner_broadcast{},
-                            find_dot_broadcast{},
-                            find_double_add_lit_broadcast{},
-                            find_add_lit_broadcast{},
-                            find_add_convs{},
-                            find_conv_dot_horiz_fusion{},
-                            find_mul_conv{},
-                            find_mul_slice_conv{},
-                            find_mul_dot{},
-                            find_dot_mul{},
-                            find_mul_add{},
-                            find_unit_ops{},
-                            find_neg_unit_ops{},
-                            eliminate_zero_point{},
-                            find_zero_ops{},
-                            find_dot_add{},
-                            find_conv_add{},
-                            find_div_const{},
-                            find_sub_const{},
-                            find_rsqrt{},
-                            find_concat_conv{},
-                            find_concat_op{},
-                            find_split_concat{},
-                            find_splits{},
-                            find_split_reshape{},
-                            find_split_transpose{});
-        dead_code_elimination{}.apply(m);
-    }
+    match::find_matches_fixpoint(m,
+                                 find_inner_broadcast{},
+                                 find_dot_broadcast{},
+                                 find_double_add_lit_broadcast{},
+                                 find_add_lit_broadcast{},
+                                 find_add_convs{},
+                                 find_conv_dot_horiz_fusion{},
+                                 find_mul_conv{},
+                                 find_mul_slice_conv{},
+                                 find_mul_dot{},
+                                 find_dot_mul{},
+                                 find_mul_add{},
+                                 find_unit_ops{},
+                                 find_neg_unit_ops{},
+                                 eliminate_zero_point{},
+                                 find_zero_ops{},
+                                 find_dot_add{},
+                                 find_conv_add{},
+                                 find_div_const{},
+                                 find_sub_const{},
+                                 find_rsqrt{},
+                                 find_concat_conv{},
+                                 find_concat_op{},
+                                 find_split_concat{},
+                                 find_splits{},
+                                 find_split_reshape{},
+                                 find_split_transpose{});
 }
 
 } // namespace MIGRAPHX_INLINE_NS
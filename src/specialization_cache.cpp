@@ -0,0 +1,224 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/time.hpp>
+#include <algorithm>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+struct shapes_hash
+{
+    std::size_t operator()(const std::vector<shape>& shapes) const
+    {
+        std::size_t h = 0;
+        for(const auto& s : shapes)
+        {
+            hash_combine(h, static_cast<int>(s.type()));
+            for(auto len : s.lens())
+                hash_combine(h, len);
+            for(auto stride : s.strides())
+                hash_combine(h, stride);
+        }
+        return h;
+    }
+};
+
+struct specialization_cache_impl
+{
+    program prog;
+    target t;
+    compile_options options;
+    std::size_t capacity = 0;
+    // Names of the parameters with dynamic shapes, whose shapes are used to look up the
+    // specializations
+    std::vector<std::string> names;
+    // A specialization is added before it is compiled, so evaluations with the same shapes wait
+    // for the compilation instead of compiling it again
+    struct entry
+    {
+        std::vector<shape> key;
+        std::shared_future<std::shared_ptr<program>> prog;
+        std::size_t id = 0;
+    };
+    // The most recently used specialization is at the front
+    std::list<entry> entries;
+    std::unordered_map<std::vector<shape>, std::list<entry>::iterator, shapes_hash> lookup;
+    std::size_t next_id = 0;
+    specialization_stats stats;
+    std::mutex mutex;
+
+    std::shared_ptr<program> get(const std::vector<shape>& key, const parameter_map& params)
+    {
+        std::promise<std::shared_ptr<program>> promise;
+        std::shared_future<std::shared_ptr<program>> cached;
+        std::size_t id = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = lookup.find(key);
+            if(it != lookup.end())
+            {
+                stats.hits++;
+                entries.splice(entries.begin(), entries, it->second);
+                cached = it->second->prog;
+            }
+            else
+            {
+                stats.misses++;
+                id = next_id++;
+                entries.push_front({key, promise.get_future().share(), id});
+                lookup[key] = entries.begin();
+                if(entries.size() > capacity)
+                {
+                    stats.evictions++;
+                    lookup.erase(entries.back().key);
+                    entries.pop_back();
+                }
+            }
+        }
+        // Wait outside of the lock when the specialization is still being compiled
+        if(cached.valid())
+            return cached.get();
+        // The cache is not locked while compiling, so evaluations with other shapes can proceed
+        try
+        {
+            auto p  = std::make_shared<program>(specialization_cache::specialize(prog, params));
+            auto ms = time<milliseconds>([&] { p->compile(t, options); });
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.compile_ms += ms;
+                stats.max_compile_ms = std::max(stats.max_compile_ms, ms);
+            }
+            promise.set_value(p);
+            return p;
+        }
+        catch(...)
+        {
+            // The evaluations waiting for it get the error, and later ones try to compile again
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = lookup.find(key);
+                if(it != lookup.end() and it->second->id == id)
+                {
+                    entries.erase(it->second);
+                    lookup.erase(it);
+                }
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+};
+
+specialization_cache::specialization_cache(program p,
+                                           target t,
+                                           compile_options options,
+                                           std::size_t capacity)
+    : impl(std::make_shared<specialization_cache_impl>())
+{
+    if(capacity == 0)
+        MIGRAPHX_THROW("SPECIALIZATION_CACHE: capacity must be at least one");
+    for(auto param : p.get_main_module()->get_parameters())
+    {
+        if(param->get_shape().dynamic())
+            impl->names.push_back(any_cast<builtin::param>(param->get_operator()).parameter);
+    }
+    std::sort(impl->names.begin(), impl->names.end());
+    impl->prog     = std::move(p);
+    impl->t        = std::move(t);
+    impl->options  = std::move(options);
+    impl->capacity = capacity;
+}
+
+std::vector<argument> specialization_cache::eval(const parameter_map& params,
+                                                 execution_environment exec_env) const
+{
+    std::vector<shape> key;
+    std::transform(impl->names.begin(),
+                   impl->names.end(),
+                   std::back_inserter(key),
+                   [&](const std::string& name) {
+                       auto it = params.find(name);
+                       if(it == params.end())
+                           MIGRAPHX_THROW("SPECIALIZATION_CACHE: parameter not found: " + name);
+                       return it->second.get_shape();
+                   });
+    return impl->get(key, params)->eval(params, exec_env);
+}
+
+specialization_stats specialization_cache::stats() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->stats;
+}
+
+program specialization_cache::specialize(program p, const parameter_map& params)
+{
+    auto* mm = p.get_main_module();
+    module sm{mm->name()};
+    std::unordered_map<instruction_ref, instruction_ref> map_ins;
+    // The parameters are added first in the same order, so they keep their order
+    for(const auto& name : mm->get_parameter_names())
+    {
+        auto param = mm->get_parameter(name);
+        auto s     = param->get_shape();
+        if(s.dynamic())
+        {
+            auto it = params.find(name);
+            if(it == params.end())
+                MIGRAPHX_THROW("SPECIALIZE: parameter not found: " + name);
+            const auto& dds = s.dyn_dims();
+            auto lens       = it->second.get_shape().lens();
+            if(it->second.get_shape().type() != s.type() or lens.size() != dds.size() or
+               not std::equal(dds.begin(), dds.end(), lens.begin(), [](const auto& dd, auto len) {
+                   return len >= dd.min and len <= dd.max;
+               }))
+            {
+                MIGRAPHX_THROW("SPECIALIZE: shape of parameter " + name +
+                               " is not in the range of its dynamic shape");
+            }
+            s = it->second.get_shape();
+        }
+        map_ins[param] = sm.add_parameter(name, s);
+    }
+    auto outputs = sm.add_instructions(mm, &map_ins);
+    sm.add_return(outputs);
+    *mm = std::move(sm);
+    return p;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,234 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_event
+{
+    std::mutex m;
+    std::condition_variable cv;
+    // Only modified by the thread evaluating the program
+    std::size_t recorded = 0;
+    std::size_t completed = 0;
+
+    void signal(std::size_t n)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            completed = std::max(completed, n);
+        }
+        cv.notify_all();
+    }
+
+    void wait(std::size_t n)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return completed >= n; });
+    }
+};
+
+struct cpu_stream
+{
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> queue;
+    std::size_t pending = 0;
+    bool stop           = false;
+    std::exception_ptr error;
+    std::thread worker;
+
+    explicit cpu_stream(std::size_t nthreads)
+        : worker([this, nthreads] {
+#ifndef MIGRAPHX_DISABLE_OMP
+              // Share the cores between the streams running concurrently
+              omp_set_num_threads(nthreads);
+#else
+              (void)nthreads;
+#endif
+              this->work();
+          })
+    {
+    }
+
+    cpu_stream(const cpu_stream&) = delete;
+    cpu_stream& operator=(const cpu_stream&) = delete;
+
+    ~cpu_stream()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    void work()
+    {
+        for(;;)
+        {
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stop or not queue.empty(); });
+                if(queue.empty())
+                    return;
+                f = std::move(queue.front());
+                queue.pop_front();
+            }
+            // Keep draining the queue after an error so events are still signaled
+            try
+            {
+                f();
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if(error == nullptr)
+                    error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m);
+                pending--;
+            }
+            cv.notify_all();
+        }
+    }
+
+    void enqueue(std::function<void()> f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            queue.push_back(std::move(f));
+            pending++;
+        }
+        cv.notify_all();
+    }
+
+    void sync()
+    {
+        std::exception_ptr e;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return pending == 0; });
+            std::swap(e, error);
+        }
+        if(e != nullptr)
+            std::rethrow_exception(e);
+    }
+};
+
+struct stream_pool
+{
+    // Stream 0 is the calling thread so it doesnt have a worker
+    std::vector<std::unique_ptr<cpu_stream>> streams;
+    std::vector<std::unique_ptr<cpu_event>> events;
+
+    explicit stream_pool(std::size_t n)
+    {
+        auto nthreads = std::max<std::size_t>(1, max_threads() / n);
+        for(std::size_t i = 1; i < n; i++)
+            streams.push_back(std::make_unique<cpu_stream>(nthreads));
+    }
+
+    cpu_stream& get_stream(std::size_t stream) const
+    {
+        if(stream == 0 or stream > streams.size())
+            MIGRAPHX_THROW("Invalid stream: " + std::to_string(stream));
+        return *streams[stream - 1];
+    }
+
+    cpu_event& get_event(std::size_t event) const
+    {
+        if(event >= events.size())
+            MIGRAPHX_THROW("Invalid event: " + std::to_string(event));
+        return *events[event];
+    }
+};
+
+context::context(std::size_t n) : pool(std::make_shared<stream_pool>(std::max<std::size_t>(n, 1)))
+{
+}
+
+std::size_t context::nstreams() const { return pool->streams.size() + 1; }
+
+void context::enqueue(std::size_t stream, std::function<void()> f) const
+{
+    if(stream == 0)
+        f();
+    else
+        pool->get_stream(stream).enqueue(std::move(f));
+}
+
+argument context::run(std::size_t stream, const std::function<argument()>& f) const
+{
+    if(stream == 0)
+        return f();
+    auto task   = std::make_shared<std::packaged_task<argument()>>(f);
+    auto result = task->get_future();
+    pool->get_stream(stream).enqueue([task] { (*task)(); });
+    return result.get();
+}
+
+void context::create_events(std::size_t num_of_events) const
+{
+    for(std::size_t i = pool->events.size(); i < num_of_events + 1; i++)
+        pool->events.push_back(std::make_unique<cpu_event>());
+}
+
+void context::record(std::size_t stream, std::size_t event) const
+{
+    auto& e = pool->get_event(event);
+    auto n  = ++e.recorded;
+    this->enqueue(stream, [&e, n] { e.signal(n); });
+}
+
+void context::wait(std::size_t stream, std::size_t event) const
+{
+    auto& e = pool->get_event(event);
+    auto n  = e.recorded;
+    this->enqueue(stream, [&e, n] { e.wait(n); });
+}
+
+void context::finish() const
+{
+    for(auto& s : pool->streams)
+        s->sync();
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
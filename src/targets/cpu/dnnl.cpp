@@ -22,6 +22,8 @@
  * THE SOFTWARE.
  */
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
 
 #if defined(__GNUC__) && __GNUC__ <= 5
 namespace std {
@@ -53,6 +55,13 @@ dnnl_context& get_dnnl_context()
     return ctx;
 }
 
+dnnl::stream& get_dnnl_stream()
+{
+    // Streams cant be shared across threads, so each thread running primitives has its own
+    thread_local dnnl::stream s{get_dnnl_context().engine}; // NOLINT
+    return s;
+}
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
@@ -68,8 +77,8 @@ dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t)
     case st::int32_type: return dt::s32;
     case st::int8_type: return dt::s8;
     case st::uint8_type: return dt::u8;
-    case st::fp8e4m3fnuz_type: MIGRAPHX_THROW("fp8e4m3fnuz unsupported in DNNL");
-    default: MIGRAPHX_THROW("Unsupported data type");
+    case st::fp8e4m3fnuz_type: throw dnnl_unsupported("fp8e4m3fnuz unsupported in DNNL");
+    default: throw dnnl_unsupported("Unsupported data type in DNNL: " + shape::name(t));
     }
 }
 #ifdef __clang__
@@ -105,6 +114,101 @@ dnnl::memory to_dnnl_memory(const argument& a)
     return to_dnnl_memory(to_dnnl_memory_desc(a.get_shape()), a);
 }
 
+dnnl::memory::desc to_dnnl_any_memory_desc(const dnnl::memory::desc& desc)
+{
+    return {desc.dims(), desc.data_type(), dnnl::memory::format_tag::any};
+}
+
+bool dnnl_memory_desc_serializable(const dnnl::memory::desc& desc)
+{
+    return desc.data.format_kind ==
+               static_cast<decltype(desc.data.format_kind)>(dnnl::memory::format_kind::blocked) and
+           desc.data.extra.flags == 0;
+}
+
+template <class T>
+static std::vector<std::int64_t> to_int64_vec(const T* x, std::size_t n)
+{
+    return {x, x + n};
+}
+
+dnnl_memory_layout to_dnnl_memory_layout(const dnnl::memory::desc& desc)
+{
+    if(not dnnl_memory_desc_serializable(desc))
+        MIGRAPHX_THROW("Memory descriptor is not a plain blocked layout");
+    const auto& d     = desc.data;
+    const auto& blk   = d.format_desc.blocking;
+    std::size_t ndims = d.ndims;
+    std::size_t nblks = blk.inner_nblks;
+    dnnl_memory_layout result;
+    result.dims           = to_int64_vec(d.dims, ndims);
+    result.data_type      = d.data_type;
+    result.format_kind    = d.format_kind;
+    result.padded_dims    = to_int64_vec(d.padded_dims, ndims);
+    result.padded_offsets = to_int64_vec(d.padded_offsets, ndims);
+    result.offset0        = d.offset0;
+    result.strides        = to_int64_vec(blk.strides, ndims);
+    result.inner_blks     = to_int64_vec(blk.inner_blks, nblks);
+    result.inner_idxs     = to_int64_vec(blk.inner_idxs, nblks);
+    return result;
+}
+
+dnnl::memory::desc to_dnnl_memory_desc(const dnnl_memory_layout& layout)
+{
+    const std::size_t max_ndims = MIGRAPHX_DNNL_PREFIX(MAX_NDIMS);
+    auto ndims                  = layout.dims.size();
+    auto nblks                  = layout.inner_blks.size();
+    if(ndims == 0 or ndims > max_ndims or nblks > max_ndims)
+        MIGRAPHX_THROW("Invalid number of dimensions for memory descriptor");
+    if(layout.padded_dims.size() != ndims or layout.padded_offsets.size() != ndims or
+       layout.strides.size() != ndims or layout.inner_idxs.size() != nblks)
+        MIGRAPHX_THROW("Inconsistent dimensions for memory descriptor");
+    if(layout.format_kind != static_cast<std::int64_t>(dnnl::memory::format_kind::blocked))
+        MIGRAPHX_THROW("Memory descriptor is not a blocked layout");
+    if(std::any_of(layout.inner_idxs.begin(), layout.inner_idxs.end(), [&](auto i) {
+           return i < 0 or i >= static_cast<std::int64_t>(ndims);
+       }))
+        MIGRAPHX_THROW("Invalid inner block index for memory descriptor");
+
+    // Start from a dense descriptor so the fields not stored are left in their default state
+    dnnl::memory::desc desc{dnnl::memory::dims(layout.dims.begin(), layout.dims.end()),
+                            static_cast<dnnl::memory::data_type>(layout.data_type),
+                            dnnl::memory::dims{}};
+    auto& d   = desc.data;
+    auto& blk = d.format_desc.blocking;
+    std::copy(layout.strides.begin(), layout.strides.end(), blk.strides);
+    std::copy(layout.padded_dims.begin(), layout.padded_dims.end(), d.padded_dims);
+    std::copy(layout.padded_offsets.begin(), layout.padded_offsets.end(), d.padded_offsets);
+    d.offset0       = layout.offset0;
+    blk.inner_nblks = static_cast<int>(nblks);
+    std::copy(layout.inner_blks.begin(), layout.inner_blks.end(), blk.inner_blks);
+    std::copy(layout.inner_idxs.begin(), layout.inner_idxs.end(), blk.inner_idxs);
+    return desc;
+}
+
+value dnnl_memory_desc_to_value(const dnnl::memory::desc& desc)
+{
+    return migraphx::to_value(to_dnnl_memory_layout(desc));
+}
+
+dnnl::memory::desc dnnl_memory_desc_from_value(const value& v)
+{
+    return to_dnnl_memory_desc(from_value<dnnl_memory_layout>(v));
+}
+
+argument dnnl_reorder_argument(const argument& a,
+                               const dnnl::memory::desc& src,
+                               const dnnl::memory::desc& dst)
+{
+    argument result{shape{shape::uint8_type, {dst.get_size()}}};
+    auto src_mem = to_dnnl_memory(src, a);
+    auto dst_mem = to_dnnl_memory(dst, result);
+    auto& stream = get_dnnl_stream();
+    dnnl::reorder(src_mem, dst_mem).execute(stream, src_mem, dst_mem);
+    stream.wait();
+    return result;
+}
+
 // clang-format off
 #define MIGRAPHX_VISIT_DNNL_ALGO(m) \
         m(undef) \
@@ -25,18 +25,45 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/env.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/cpu/export.h>
+#include <functional>
+#include <memory>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct context
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NSTREAMS)
+
+struct stream_pool;
+
+/**
+ * Stream 0 executes inline on the thread evaluating the program, while each
+ * additional stream is a worker thread draining a queue in order. Events
+ * order work across streams, the same way as events on the gpu.
+ */
+struct MIGRAPHX_CPU_EXPORT context
 {
-    void finish() const {}
+    context(std::size_t n = value_of(MIGRAPHX_NSTREAMS{}, 1));
+
+    std::size_t nstreams() const;
+
+    /// Add work to the end of the stream's queue
+    void enqueue(std::size_t stream, std::function<void()> f) const;
+    /// Run work on the stream and wait for its result
+    argument run(std::size_t stream, const std::function<argument()>& f) const;
+
+    void create_events(std::size_t num_of_events) const;
+    void record(std::size_t stream, std::size_t event) const;
+    void wait(std::size_t stream, std::size_t event) const;
+
+    /// Wait for all streams to finish, rethrowing any error from their work
+    void finish() const;
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -49,6 +76,9 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    std::shared_ptr<stream_pool> pool;
 };
 
 } // namespace cpu
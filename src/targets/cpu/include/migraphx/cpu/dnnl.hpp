@@ -29,6 +29,10 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/value.hpp>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <migraphx/errors.hpp>
 #include <migraphx/assert.hpp>
@@ -59,6 +63,15 @@ struct dnnl_context
 
 dnnl_context& get_dnnl_context();
 
+/// Thrown when oneDNN has no implementation for the data types of an operator, so lowering can
+/// keep the reference operator. Other errors are thrown as a migraphx::exception.
+struct dnnl_unsupported : exception
+{
+    explicit dnnl_unsupported(const std::string& msg) : exception(0, msg) {}
+};
+
+dnnl::stream& get_dnnl_stream();
+
 dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t);
 
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n);
@@ -75,6 +88,55 @@ dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a);
 
 dnnl::memory to_dnnl_memory(const argument& a);
 
+// Descriptor with the same dims and type that lets the primitive choose the layout
+dnnl::memory::desc to_dnnl_any_memory_desc(const dnnl::memory::desc& desc);
+
+// Fields of a blocked memory descriptor, so it can be saved and read back by another build of
+// dnnl
+struct dnnl_memory_layout : reflect_equality<dnnl_memory_layout>,
+                            reflect_stream<dnnl_memory_layout>
+{
+    std::vector<std::int64_t> dims;
+    std::int64_t data_type   = 0;
+    std::int64_t format_kind = 0;
+    std::vector<std::int64_t> padded_dims;
+    std::vector<std::int64_t> padded_offsets;
+    std::int64_t offset0 = 0;
+    std::vector<std::int64_t> strides;
+    std::vector<std::int64_t> inner_blks;
+    std::vector<std::int64_t> inner_idxs;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.dims, "dims"),
+                    f(self.data_type, "data_type"),
+                    f(self.format_kind, "format_kind"),
+                    f(self.padded_dims, "padded_dims"),
+                    f(self.padded_offsets, "padded_offsets"),
+                    f(self.offset0, "offset0"),
+                    f(self.strides, "strides"),
+                    f(self.inner_blks, "inner_blks"),
+                    f(self.inner_idxs, "inner_idxs"));
+    }
+};
+
+// Only plain blocked layouts without extra data, such as int8 compensation, can be saved
+bool dnnl_memory_desc_serializable(const dnnl::memory::desc& desc);
+
+dnnl_memory_layout to_dnnl_memory_layout(const dnnl::memory::desc& desc);
+
+dnnl::memory::desc to_dnnl_memory_desc(const dnnl_memory_layout& layout);
+
+value dnnl_memory_desc_to_value(const dnnl::memory::desc& desc);
+
+dnnl::memory::desc dnnl_memory_desc_from_value(const value& v);
+
+// Copy the data into a buffer with the layout of dst
+argument dnnl_reorder_argument(const argument& a,
+                               const dnnl::memory::desc& src,
+                               const dnnl::memory::desc& dst);
+
 dnnl::algorithm to_dnnl_algo(const std::string& name);
 
 std::string to_string(const dnnl::algorithm& algo);
@@ -104,16 +166,29 @@ execute_wrapper<F> make_execute_wrapper(F f)
     return {std::move(f)};
 }
 
+// Weights reordered from the layout they were packed in, shared by the copies of an op
+struct reordered_weights
+{
+    std::once_flag flag;
+    argument weights;
+};
+
 template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
+    // Shape of the weights before they were reordered into the layout preferred by the primitive
+    optional<shape> packed_weights = nullopt;
+    // Memory descriptor of the layout the packed weights were reordered into
+    optional<dnnl_memory_layout> packed_weights_desc = nullopt;
     std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"),
+                    f(self.packed_weights, "packed_weights"),
+                    f(self.packed_weights_desc, "packed_weights_desc"));
     }
 
     template <class Self, class F>
@@ -173,6 +248,16 @@ struct dnnl_op : auto_register_op<Derived>
 #endif
         return str == nullptr ? "" : str;
     }
+    static dnnl::memory::desc weights_desc(const Primitive& prim)
+    {
+        auto desc = prim.get_primitive_desc();
+#ifdef MIGRAPHX_ENABLE_ZENDNN
+        return dnnl::memory::desc{
+            *zendnn_primitive_desc_query_md(desc, zendnn_query_weights_md, 0)};
+#else
+        return dnnl::memory::desc{*dnnl_primitive_desc_query_md(desc, dnnl_query_weights_md, 0)};
+#endif
+    }
     // Map arg index to arg in dnnl
     std::vector<int> arg_map(int size) const
     {
@@ -235,9 +320,26 @@ struct dnnl_op : auto_register_op<Derived>
         });
         return m;
     }
+    // Index of the input passed as the weights of the primitive
+    std::ptrdiff_t weights_index(std::size_t input_size) const
+    {
+        auto m  = create_arg_map(input_size);
+        auto it = std::find(m.begin(), m.end(), MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        if(it == m.end())
+            return -1;
+        return it - m.begin();
+    }
+    // Replace the shape of packed weights with the shape they had before packing
+    std::vector<shape> unpack_shapes(std::vector<shape> inputs) const
+    {
+        if(packed_weights.has_value())
+            inputs.at(weights_index(inputs.size())) = *packed_weights;
+        return inputs;
+    }
     std::unordered_map<int, dnnl::memory::desc>
-    to_memory_desc(const shape& output_shape, const std::vector<shape>& inputs) const
+    to_memory_desc(const shape& output_shape, const std::vector<shape>& packed_inputs) const
     {
+        auto inputs      = unpack_shapes(packed_inputs);
         const auto& self = static_cast<const Derived&>(*this);
         std::unordered_map<int, dnnl::memory::desc> result;
         result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
@@ -248,8 +350,23 @@ struct dnnl_op : auto_register_op<Derived>
         {
             result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i, output_shape));
         }
+        if(packed_weights.has_value())
+        {
+            auto& w = result.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+            w       = to_dnnl_any_memory_desc(w);
+        }
         return result;
     }
+    // The descriptors used to execute the primitive, which has the layout it
+    // chose for packed weights
+    std::unordered_map<int, dnnl::memory::desc>
+    to_execute_memory_desc(const Primitive& prim,
+                           std::unordered_map<int, dnnl::memory::desc> m) const
+    {
+        if(packed_weights.has_value())
+            m[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] = weights_desc(prim);
+        return m;
+    }
     dnnl::primitive_attr
     get_primitive_attr(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
@@ -285,10 +402,19 @@ struct dnnl_op : auto_register_op<Derived>
     Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         const auto& self = static_cast<const Derived&>(*this);
-        auto desc        = self.get_desc(m);
-        auto attr        = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
-        auto pd          = self.get_primitive_desc(desc, attr);
-        return Primitive(pd);
+        try
+        {
+            auto desc = self.get_desc(m);
+            auto attr = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
+            auto pd   = self.get_primitive_desc(desc, attr);
+            return Primitive(pd);
+        }
+        catch(const dnnl::error& e)
+        {
+            if(static_cast<dnnl::status>(e.status) != dnnl::status::unimplemented)
+                throw;
+            throw dnnl_unsupported(self.name() + ": no oneDNN implementation: " + e.what());
+        }
     }
     argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
     {
@@ -306,7 +432,30 @@ struct dnnl_op : auto_register_op<Derived>
         auto md        = to_memory_desc(output_shape, inputs);
         auto prim      = get_primitive(md);
         auto impl_name = impl(prim);
-        return {{"impl", impl_name}};
+        value result   = {{"impl", impl_name}};
+        auto w         = weights_index(inputs.size());
+        if(packed_weights.has_value() or w < 0)
+            return result;
+        auto wmd    = md.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        auto any_md = md;
+        // Check if the primitive prefers another layout for the weights, so
+        // they can be packed when they are constant
+        any_md[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] = to_dnnl_any_memory_desc(wmd);
+        try
+        {
+            auto packed = weights_desc(get_primitive(any_md));
+            if(packed != wmd and dnnl_memory_desc_serializable(packed))
+                result["weights"] = {{"index", w},
+                                     {"src", dnnl_memory_desc_to_value(wmd)},
+                                     {"dst", dnnl_memory_desc_to_value(packed)}};
+        }
+        catch(const dnnl_unsupported&)
+        {
+        }
+        catch(const dnnl::error&)
+        {
+        }
+        return result;
     }
 
     void finalize(context&, const shape& output_shape, std::vector<shape> inputs)
@@ -317,7 +466,24 @@ struct dnnl_op : auto_register_op<Derived>
         auto name        = self.name();
         auto md          = to_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
+        md               = to_execute_memory_desc(prim, md);
         auto arg_lookup  = create_arg_map(inputs.size());
+        auto w           = weights_index(inputs.size());
+        // The weights were packed for the primitive chosen when the program
+        // was compiled, which can differ from this one once it is loaded on
+        // another machine, so they are reordered into its layout
+        optional<dnnl::memory::desc> packed_desc = nullopt;
+        if(packed_weights.has_value())
+        {
+            if(not packed_weights_desc.has_value())
+                MIGRAPHX_THROW(name + ": Missing memory descriptor for packed weights");
+            auto desc = to_dnnl_memory_desc(*packed_weights_desc);
+            if(desc != md.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)))
+                packed_desc = desc;
+        }
+        // The packed weights are a constant literal, so they are reordered on the first call and
+        // the result is reused by every call after it
+        auto reordered = std::make_shared<reordered_weights>();
 #ifndef NDEBUG
         auto prim_attr = get_primitive_attr(md);
 #endif
@@ -326,7 +492,8 @@ struct dnnl_op : auto_register_op<Derived>
             // Check that the memory descriptors have not changed
             auto debug_args = args;
             debug_args.pop_back();
-            auto debug_md = to_memory_desc(output_shape, to_shapes(debug_args));
+            auto debug_md =
+                to_execute_memory_desc(prim, to_memory_desc(output_shape, to_shapes(debug_args)));
             for(auto&& p : debug_md)
             {
                 if(md.count(p.first) == 0)
@@ -390,7 +557,15 @@ struct dnnl_op : auto_register_op<Derived>
                 to_dnnl_memory(md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
             for(int i = 0; i < args.size() - 1; i++)
                 m[arg_lookup[i]] = to_dnnl_memory(md.at(arg_lookup[i]), args[i]);
-            prim.execute(get_dnnl_context().stream, m);
+            if(packed_desc.has_value())
+            {
+                const auto& wmd = md.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+                std::call_once(reordered->flag, [&] {
+                    reordered->weights = dnnl_reorder_argument(args[w], *packed_desc, wmd);
+                });
+                m[arg_lookup[w]] = to_dnnl_memory(wmd, reordered->weights);
+            }
+            prim.execute(get_dnnl_stream(), m);
             return args.back();
         });
     }
@@ -425,8 +600,9 @@ struct dnnl_extend_op : dnnl_op<Derived, Primitive>
         const auto& self = static_cast<const Derived&>(*this);
         // Compensate for allocation
         inputs.pop_back();
-        self.required(check_shapes(inputs, self));
-        auto r = migraphx::compute_shape(op, this->trim_post_op_inputs(inputs));
+        auto unpacked = this->unpack_shapes(inputs);
+        self.required(check_shapes(unpacked, self));
+        auto r = migraphx::compute_shape(op, this->trim_post_op_inputs(unpacked));
         // Call to get_primitive to make sure an algo is available
         this->get_primitive(this->to_memory_desc(r, inputs));
         return r;
@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_JIT_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_JIT_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/cpu/export.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+namespace cpu {
+
+/// Generate a `cpu::jit` kernel that evaluates the pointwise module `pm` for every element of
+/// `output`. Returns nothing when the module uses a type or function the host code generator
+/// does not support.
+MIGRAPHX_CPU_EXPORT optional<operation>
+make_pointwise_kernel(const module& pm, const std::vector<shape>& inputs, const shape& output);
+
+/// Generate a `cpu::jit` kernel for the submodule of a `fused_reduce` over `axes`. Each
+/// work item reduces one output element, so the pointwise instructions before and after the
+/// reduction are fused into the same loop.
+MIGRAPHX_CPU_EXPORT optional<operation> make_reduce_kernel(const module& rm,
+                                                            const std::vector<std::int64_t>& axes,
+                                                            const std::vector<shape>& inputs,
+                                                            const shape& output);
+
+/// Compiles kernel sources into shared objects with the host compiler, and caches them on disk.
+struct MIGRAPHX_CPU_EXPORT kernel_compiler
+{
+    /// Use the compiler migraphx was built with, and the cache directory from the environment
+    kernel_compiler();
+
+    fs::path compiler;
+    /// The kernels are not cached on disk when this is empty. The directory is only used when it
+    /// is owned by the current user and no other user can access it.
+    fs::path cache_dir;
+
+    /// Check that the compiler exists
+    bool available() const;
+
+    /// Return the shared object for the source. Shared objects are cached keyed by a hash of the
+    /// source, the compiler flags and the host cpu, and a cached one is only used when the key
+    /// stored next to it matches.
+    std::vector<char> compile(const std::string& src) const;
+};
+
+/// Compile the kernel source with the default `kernel_compiler`.
+MIGRAPHX_CPU_EXPORT std::vector<char> compile_kernel(const std::string& src);
+
+/// Compile the kernels of all the `cpu::jit` operators in parallel to warm the cache.
+MIGRAPHX_CPU_EXPORT void compile_kernels(const std::vector<operation>& ops);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_WRITE_LITERALS_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/cpu/context.hpp>
 #include <string>
 
 namespace migraphx {
@@ -32,8 +33,14 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 namespace cpu {
 
-struct write_literals
+/**
+ * Replaces literals with `cpu::literal`. Constant weights of dnnl primitives
+ * are first reordered into the layout the primitive prefers, so they are not
+ * reordered each time the primitive runs.
+ */
+struct MIGRAPHX_CPU_EXPORT write_literals
 {
+    context* ctx = nullptr;
     std::string name() const { return "cpu::write_literals"; }
     void apply(module& m) const;
 };
@@ -0,0 +1,749 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/jit.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/fileutils.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_JIT_CACHE_DIR)
+
+// NOLINTNEXTLINE
+static const char* const kernel_preamble = R"__migraphx__(
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace {
+namespace mgx {
+
+using std::acos;
+using std::acosh;
+using std::asin;
+using std::asinh;
+using std::atan;
+using std::atanh;
+using std::ceil;
+using std::cos;
+using std::cosh;
+using std::erf;
+using std::exp;
+using std::floor;
+using std::fmod;
+using std::log;
+using std::nearbyint;
+using std::pow;
+using std::remainder;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+using std::tan;
+using std::tanh;
+
+// Reductions accumulate in the same types as the reference implementation
+template <class T>
+using accumulator = std::conditional_t<
+    std::is_floating_point<T>{},
+    double,
+    std::conditional_t<std::is_signed<T>{}, std::int64_t, std::uint64_t>>;
+
+template <class T>
+T abs(T x)
+{
+    if constexpr(std::is_floating_point<T>{})
+        return std::fabs(x);
+    else if constexpr(std::is_signed<T>{})
+        return x < 0 ? -x : x;
+    else
+        return x;
+}
+
+template <class T>
+auto rsqrt(T x)
+{
+    return 1 / std::sqrt(x);
+}
+
+template <class T>
+bool isnan(T x)
+{
+    return std::isnan(static_cast<double>(x));
+}
+
+template <class T>
+bool isinf(T x)
+{
+    return std::isinf(static_cast<double>(x));
+}
+
+template <class T, class U>
+std::common_type_t<T, U> max(T x, U y)
+{
+    return x < y ? y : x;
+}
+
+template <class T, class U>
+std::common_type_t<T, U> min(T x, U y)
+{
+    return y < x ? y : x;
+}
+
+template <class C, class T, class U>
+std::common_type_t<T, U> where(C c, T x, U y)
+{
+    return c ? x : y;
+}
+
+template <class T, class U>
+T convert(U x)
+{
+    if(isnan(x))
+        return std::numeric_limits<T>::quiet_NaN();
+    // Clamp to the range of the target type like the reference convert
+    auto y = static_cast<T>(x);
+    return min(max(y, std::numeric_limits<T>::lowest()), std::numeric_limits<T>::max());
+}
+
+} // namespace mgx
+} // namespace
+)__migraphx__";
+
+static bool is_supported_type(const shape& s)
+{
+    static const std::set<shape::type_t> types = {shape::bool_type,
+                                                  shape::float_type,
+                                                  shape::double_type,
+                                                  shape::int8_type,
+                                                  shape::uint8_type,
+                                                  shape::int16_type,
+                                                  shape::uint16_type,
+                                                  shape::int32_type,
+                                                  shape::uint32_type,
+                                                  shape::int64_type,
+                                                  shape::uint64_type};
+    return not s.dynamic() and contains(types, s.type());
+}
+
+static bool is_supported_function(const std::string& name)
+{
+    static const std::set<std::string> functions = {
+        "abs", "acos", "acosh", "asin", "asinh", "atan", "atanh", "ceil", "convert", "cos", "cosh",
+        "erf", "exp", "floor", "fmod", "isinf", "isnan", "log", "max", "min", "nearbyint", "pow",
+        "remainder", "rsqrt", "sin", "sinh", "sqrt", "tan", "tanh", "where"};
+    return contains(functions, name);
+}
+
+// Check that the host code generator can emit the operator as an expression
+static bool is_supported_point_op(instruction_ref ins)
+{
+    if(not ins->module_inputs().empty() or not is_supported_type(ins->get_shape()))
+        return false;
+    auto attributes = ins->get_operator().attributes();
+    return attributes.contains("point_op") and
+           not attributes["point_op"].to<std::string>().empty();
+}
+
+// Generate the expression for the operator, or nothing if it calls an unsupported function
+static optional<std::string> generate_point_op(cpp_generator& g,
+                                               const operation& op,
+                                               const std::vector<std::string>& args)
+{
+    bool supported = true;
+    g.fmap([&](const std::string& fname) {
+        supported = supported and is_supported_function(fname);
+        return "mgx::" + fname;
+    });
+    auto result = g.generate_point_op(op, args);
+    g.fmap([](const std::string& fname) { return "mgx::" + fname; });
+    if(not supported)
+        return nullopt;
+    return result;
+}
+
+// Generate a function for the pointwise module and return its name
+static optional<std::string> generate_point_function(cpp_generator& g, const module& pm)
+{
+    for(auto ins : iterator_for(pm))
+    {
+        if(ins->name() == "@return")
+            continue;
+        if(not is_supported_type(ins->get_shape()))
+            return nullopt;
+        if(ins->name() == "@param")
+            continue;
+        if(ins->name() == "@literal")
+        {
+            // Single byte integers would be printed as characters
+            const auto& s = ins->get_shape();
+            if(s.elements() != 1 or (s.type_size() == 1 and s.type() != shape::bool_type))
+                return nullopt;
+            continue;
+        }
+        if(not is_supported_point_op(ins))
+            return nullopt;
+    }
+    bool supported = true;
+    g.fmap([&](const std::string& fname) {
+        supported = supported and is_supported_function(fname);
+        return "mgx::" + fname;
+    });
+    auto f = g.generate_module(pm).set_attributes({"static", "inline"});
+    g.fmap([](const std::string& fname) { return "mgx::" + fname; });
+    if(not supported)
+        return nullopt;
+    return g.create_function(f);
+}
+
+// Expression for the offset in a tensor with the given strides of the element at index i of the
+// standard layout of lens. Dimensions of length 1 do not contribute, so this also computes the
+// outer and inner offsets of a reduction.
+static std::string index_expr(const std::string& i,
+                              const std::vector<std::size_t>& lens,
+                              const std::vector<std::size_t>& strides)
+{
+    shape std_shape{shape::float_type, lens};
+    if(strides == std_shape.strides())
+        return i;
+    std::vector<std::string> terms;
+    for(std::size_t d = 0; d < lens.size(); d++)
+    {
+        if(lens[d] == 1 or strides[d] == 0)
+            continue;
+        auto std_stride = std_shape.strides()[d];
+        std::string x   = i;
+        if(std_stride != 1)
+            x = "(" + x + " / " + std::to_string(std_stride) + ")";
+        // The outermost dimension does not wrap around
+        if(std_stride * lens[d] != std_shape.elements())
+            x = "(" + x + " % " + std::to_string(lens[d]) + ")";
+        if(strides[d] != 1)
+            x += " * " + std::to_string(strides[d]);
+        terms.push_back(x);
+    }
+    if(terms.empty())
+        return "0";
+    return join_strings(terms, " + ");
+}
+
+static std::string kernel_signature(const std::string& symbol)
+{
+    return "extern \"C\" void " + symbol +
+           "(void* const* args, std::size_t start, std::size_t end)\n{\n";
+}
+
+static std::string kernel_pointers(const std::vector<shape>& inputs, const shape& output)
+{
+    std::stringstream ss;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        ss << "    auto* p" << i << " = static_cast<const " << shape::cpp_type(inputs[i].type())
+           << "*>(args[" << i << "]);\n";
+    }
+    ss << "    auto* y = static_cast<" << shape::cpp_type(output.type()) << "*>(args["
+       << inputs.size() << "]);\n";
+    return ss.str();
+}
+
+static operation make_jit_op(const std::string& src,
+                             const std::string& symbol,
+                             std::size_t global,
+                             std::size_t grain)
+{
+    return make_op("cpu::jit",
+                   {{"src", src}, {"symbol", symbol}, {"global", global}, {"grain", grain}});
+}
+
+optional<operation>
+make_pointwise_kernel(const module& pm, const std::vector<shape>& inputs, const shape& output)
+{
+    auto names = pm.get_parameter_names();
+    std::sort(names.begin(), names.end());
+    if(names.size() != inputs.size() or not is_supported_type(output) or
+       not std::all_of(inputs.begin(), inputs.end(), &is_supported_type))
+        return nullopt;
+    cpp_generator g;
+    auto f = generate_point_function(g, pm);
+    if(not f)
+        return nullopt;
+
+    auto shapes = inputs;
+    shapes.push_back(output);
+    shapes = reduce_dims(shapes);
+    const auto& out = shapes.back();
+
+    std::vector<std::string> args;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+        args.push_back("p" + std::to_string(i) + "[" +
+                       index_expr("i", shapes[i].lens(), shapes[i].strides()) + "]");
+
+    auto symbol = to_c_id(pm.name()) + "_kernel";
+    std::stringstream ss;
+    ss << kernel_preamble << g.str() << kernel_signature(symbol)
+       << kernel_pointers(inputs, output);
+    ss << "    for(std::size_t i = start; i < end; i++)\n";
+    ss << "        y[" << index_expr("i", out.lens(), out.strides()) << "] = " << *f << "("
+       << join_strings(args, ", ") << ");\n";
+    ss << "}\n";
+    return make_jit_op(ss.str(), symbol, output.elements(), 4096);
+}
+
+static optional<std::pair<std::string, std::string>> reduce_init_op(const std::string& name)
+{
+    if(name == "reduce_sum" or name == "reduce_mean")
+        return std::make_pair("0", "${0} + ${1}");
+    if(name == "reduce_prod")
+        return std::make_pair("1", "${0} * ${1}");
+    if(name == "reduce_max")
+        return std::make_pair("std::numeric_limits<${type}>::lowest()", "mgx::max(${0}, ${1})");
+    if(name == "reduce_min")
+        return std::make_pair("std::numeric_limits<${type}>::max()", "mgx::min(${0}, ${1})");
+    return nullopt;
+}
+
+optional<operation> make_reduce_kernel(const module& rm,
+                                       const std::vector<std::int64_t>& axes,
+                                       const std::vector<shape>& inputs,
+                                       const shape& output)
+{
+    auto names = rm.get_parameter_names();
+    std::sort(names.begin(), names.end());
+    if(inputs.empty() or names.size() != inputs.size() or not is_supported_type(output) or
+       not std::all_of(inputs.begin(), inputs.end(), &is_supported_type))
+        return nullopt;
+
+    // Each work item computes one element of the reduced shape, and iterates over the reduced
+    // axes with an inner index
+    auto lens       = inputs.front().lens();
+    auto outer_lens = lens;
+    std::vector<std::size_t> inner_lens(lens.size(), 1);
+    for(auto axis : axes)
+    {
+        if(axis < 0 or axis >= static_cast<std::int64_t>(lens.size()))
+            return nullopt;
+        outer_lens[axis] = 1;
+        inner_lens[axis] = lens[axis];
+    }
+    if(lens == outer_lens)
+        return nullopt;
+    auto ninner      = shape{shape::float_type, inner_lens}.elements();
+    auto nouter      = shape{shape::float_type, outer_lens}.elements();
+    auto sorted_axes = axes;
+    std::sort(sorted_axes.begin(), sorted_axes.end());
+
+    cpp_generator g;
+    // Variables of full shape are lambdas of the inner index, and the reduced ones are scalars
+    std::unordered_map<instruction_ref, std::string> vars;
+    std::unordered_set<instruction_ref> full;
+    std::unordered_map<const_module_ref, std::string> functions;
+    auto use = [&](instruction_ref x) {
+        return contains(full, x) ? vars.at(x) + "(j)" : vars.at(x);
+    };
+    std::stringstream body;
+    optional<instruction_ref> result;
+    for(auto ins : iterator_for(rm))
+    {
+        if(ins->name() == "@return")
+        {
+            result = ins->inputs().front();
+            break;
+        }
+        const auto& s = ins->get_shape();
+        if(not is_supported_type(s))
+            return nullopt;
+        bool is_full = s.lens() == lens;
+        if(not is_full and s.lens() != outer_lens)
+            return nullopt;
+        auto var  = "z" + std::to_string(vars.size());
+        auto type = shape::cpp_type(s.type());
+        vars[ins] = var;
+        if(is_full)
+            full.insert(ins);
+        if(ins->name() == "@param")
+        {
+            auto pname        = any_cast<builtin::param>(ins->get_operator()).parameter;
+            auto i            = std::find(names.begin(), names.end(), pname) - names.begin();
+            const auto& input = inputs[i];
+            if(input.lens() != s.lens())
+                return nullopt;
+            auto p = "p" + std::to_string(i);
+            if(is_full)
+            {
+                body << "        auto b" << var << " = "
+                     << index_expr("o", outer_lens, input.strides()) << ";\n";
+                body << "        auto " << var << " = [&](std::size_t j) { return " << p << "[b"
+                     << var << " + " << index_expr("j", inner_lens, input.strides())
+                     << "]; };\n";
+            }
+            else
+            {
+                body << "        auto " << var << " = " << p << "["
+                     << index_expr("o", outer_lens, input.strides()) << "];\n";
+            }
+        }
+        else if(ins->name() == "multibroadcast")
+        {
+            auto x = ins->inputs().front();
+            if(not is_full or contains(full, x) or x->get_shape().lens() != outer_lens)
+                return nullopt;
+            body << "        auto " << var << " = [&](std::size_t) { return " << vars.at(x)
+                 << "; };\n";
+        }
+        else if(contains(ins->name(), "reduce_"))
+        {
+            auto x  = ins->inputs().front();
+            auto io = reduce_init_op(ins->name());
+            auto v  = ins->get_operator().to_value();
+            if(not io or is_full or not contains(full, x) or not v.contains("axes"))
+                return nullopt;
+            auto raxes = v["axes"].to_vector<std::int64_t>();
+            std::sort(raxes.begin(), raxes.end());
+            if(raxes != sorted_axes)
+                return nullopt;
+            auto acc = "mgx::accumulator<" + type + ">";
+            std::unordered_map<std::string, std::string> keys = {
+                {"type", acc}, {"0", "a" + var}, {"1", use(x)}};
+            body << "        " << acc << " a" << var << " = " << interpolate_string(io->first, keys)
+                 << ";\n";
+            body << "        for(std::size_t j = 0; j < " << ninner << "; j++)\n";
+            body << "            a" << var << " = " << interpolate_string(io->second, keys)
+                 << ";\n";
+            if(ins->name() == "reduce_mean")
+                body << "        a" << var << " /= " << acc << "(" << ninner << ");\n";
+            body << "        auto " << var << " = " << type << "(a" << var << ");\n";
+        }
+        else
+        {
+            if(std::any_of(ins->inputs().begin(), ins->inputs().end(), [&](auto x) {
+                   return contains(full, x) != is_full;
+               }))
+                return nullopt;
+            std::vector<std::string> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           [&](auto x) { return use(x); });
+            optional<std::string> call;
+            if(ins->name() == "pointwise" and ins->module_inputs().size() == 1)
+            {
+                const auto* pm = ins->module_inputs().front();
+                if(not contains(functions, pm))
+                {
+                    auto f = generate_point_function(g, *pm);
+                    if(not f)
+                        return nullopt;
+                    functions[pm] = *f;
+                }
+                call = functions.at(pm) + "(" + join_strings(args, ", ") + ")";
+            }
+            else if(is_supported_point_op(ins))
+            {
+                call = generate_point_op(g, ins->get_operator(), args);
+            }
+            if(not call)
+                return nullopt;
+            if(is_full)
+                body << "        auto " << var << " = [&](std::size_t j) { return " << type << "("
+                     << *call << "); };\n";
+            else
+                body << "        auto " << var << " = " << type << "(" << *call << ");\n";
+        }
+    }
+    if(not result or output.type() != (*result)->get_shape().type() or
+       output.lens() != (*result)->get_shape().lens())
+        return nullopt;
+
+    auto symbol = to_c_id(rm.name()) + "_kernel";
+    std::stringstream ss;
+    ss << kernel_preamble << g.str() << kernel_signature(symbol)
+       << kernel_pointers(inputs, output);
+    ss << "    for(std::size_t o = start; o < end; o++)\n    {\n" << body.str();
+    if(contains(full, *result))
+    {
+        ss << "        auto by = " << index_expr("o", outer_lens, output.strides()) << ";\n";
+        ss << "        for(std::size_t j = 0; j < " << ninner << "; j++)\n";
+        ss << "            y[by + " << index_expr("j", inner_lens, output.strides())
+           << "] = " << use(*result) << ";\n";
+    }
+    else
+    {
+        ss << "        y[" << index_expr("o", outer_lens, output.strides())
+           << "] = " << vars.at(*result) << ";\n";
+    }
+    ss << "    }\n}\n";
+    return make_jit_op(ss.str(), symbol, nouter, std::max<std::size_t>(1, 4096 / ninner));
+}
+
+// The kernels are compiled for the host cpu, so the cache key includes its model and feature
+// flags. This keeps a cache in a home directory shared between machines from loading a kernel
+// built for a different instruction set.
+static std::string host_cpu_id()
+{
+    static const std::string id = [] {
+        std::stringstream ss;
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        const std::vector<std::string> keys = {
+            "vendor_id", "model name", "flags", "CPU implementer", "CPU part", "Features"};
+        // Only the first processor is read, as they all report the same model
+        while(std::getline(cpuinfo, line) and not trim(line).empty())
+        {
+            auto key = trim(line.substr(0, line.find(':')));
+            if(contains(keys, key))
+                ss << line << "\n";
+        }
+        return ss.str();
+    }();
+    return id;
+}
+
+static fs::path default_kernel_cache_dir()
+{
+    auto dir = string_value_of(MIGRAPHX_CPU_JIT_CACHE_DIR{});
+    if(not dir.empty())
+        return dir;
+    auto cache = string_value_of("XDG_CACHE_HOME");
+    if(not cache.empty())
+        return fs::path{cache} / "migraphx" / "cpu-jit";
+    auto home = string_value_of("HOME");
+    if(not home.empty())
+        return fs::path{home} / ".cache" / "migraphx" / "cpu-jit";
+    return {};
+}
+
+// The shared objects in the cache are loaded into the process, so the directory must be owned
+// by the current user and not be writable by anyone else. A new directory is created with mode
+// 0700, and an existing one only readable by others is restricted to it.
+static bool prepare_cache_dir(const fs::path& dir)
+{
+    std::error_code ec;
+    if(not fs::exists(dir, ec))
+    {
+        fs::create_directories(dir, ec);
+        if(ec)
+            return false;
+        fs::permissions(dir, fs::perms::owner_all, ec);
+        if(ec)
+            return false;
+    }
+#ifdef _WIN32
+    return fs::is_directory(dir, ec);
+#else
+    struct stat st = {};
+    if(lstat(dir.c_str(), &st) != 0 or not S_ISDIR(st.st_mode) or st.st_uid != geteuid())
+        return false;
+    if((st.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+        return false;
+    if((st.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+        return chmod(dir.c_str(), S_IRWXU) == 0;
+    return true;
+#endif
+}
+
+static std::string unique_suffix()
+{
+    std::stringstream ss;
+    ss << std::hex << std::this_thread::get_id() << "-"
+       << std::chrono::steady_clock::now().time_since_epoch().count();
+    return ss.str();
+}
+
+// Write the file under a temporary name first, so concurrent compiles of the same kernel never
+// see a partially written file
+static void write_cache_file(const fs::path& path, const std::vector<char>& buffer)
+{
+    auto tmp = path;
+    tmp += "." + unique_suffix();
+    write_buffer(tmp, buffer);
+    fs::rename(tmp, path);
+}
+
+static void write_cache_file(const fs::path& path, const std::string& s)
+{
+    write_cache_file(path, std::vector<char>(s.begin(), s.end()));
+}
+
+kernel_compiler::kernel_compiler()
+    : compiler(src_compiler{}.compiler), cache_dir(default_kernel_cache_dir())
+{
+}
+
+bool kernel_compiler::available() const
+{
+    std::error_code ec;
+    if(compiler.has_parent_path())
+        return fs::is_regular_file(compiler, ec);
+    // Search the path for a bare compiler name
+    for(const auto& dir : split_string(string_value_of("PATH"), ':'))
+    {
+        if(not dir.empty() and fs::is_regular_file(fs::path{dir} / compiler, ec))
+            return true;
+    }
+    return false;
+}
+
+std::vector<char> kernel_compiler::compile(const std::string& src) const
+{
+    if(not available())
+        MIGRAPHX_THROW("cpu::jit: compiler not found: " + compiler.string());
+    src_compiler sc;
+    sc.compiler = compiler;
+    sc.flags    = {"-std=c++17", "-O3", "-march=native", "-fPIC", "-shared"};
+    sc.output   = make_shared_object_filename("kernel");
+
+    if(cache_dir.empty() or not prepare_cache_dir(cache_dir))
+        return sc.compile({src_file{"kernel.cpp", src}});
+
+    // The source is stored next to the shared object with everything else in the key, to
+    // detect hash collisions
+    auto key_src = sc.compiler.string() + "\n" + join_strings(sc.flags, " ") + "\n" +
+                   host_cpu_id() + "\n" + src;
+    std::stringstream key_ss;
+    key_ss << std::hex << hash_value(key_src);
+    auto key      = key_ss.str();
+    auto so_path  = cache_dir / make_shared_object_filename(key);
+    auto src_path = cache_dir / (key + ".cpp");
+    std::error_code ec;
+    if(fs::exists(src_path, ec) and fs::exists(so_path, ec) and read_string(src_path) == key_src)
+        return read_buffer(so_path);
+
+    auto image = sc.compile({src_file{"kernel.cpp", src}});
+    write_cache_file(so_path, image);
+    write_cache_file(src_path, key_src);
+    return image;
+}
+
+std::vector<char> compile_kernel(const std::string& src) { return kernel_compiler{}.compile(src); }
+
+void compile_kernels(const std::vector<operation>& ops)
+{
+    std::vector<std::string> srcs;
+    for(const auto& op : ops)
+    {
+        auto src = op.to_value()["src"].to<std::string>();
+        if(not contains(srcs, src))
+            srcs.push_back(src);
+    }
+    kernel_compiler compiler;
+    // Without a cache the kernels are compiled when they are finalized
+    if(compiler.cache_dir.empty() or not prepare_cache_dir(compiler.cache_dir))
+        return;
+    par_for(srcs.size(), [&](auto i) { compiler.compile(srcs[i]); });
+}
+
+struct jit_kernel
+{
+    std::string src;
+    std::string symbol;
+    std::size_t global = 0;
+    std::size_t grain  = 1;
+    std::function<void(void* const*, std::size_t, std::size_t)> kernel = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.src, "src"),
+                    f(self.symbol, "symbol"),
+                    f(self.global, "global"),
+                    f(self.grain, "grain"));
+    }
+
+    std::string name() const { return "cpu::jit"; }
+
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.has_at_least(1);
+        return inputs.back();
+    }
+
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        kernel = dynamic_loader{compile_kernel(src)}
+                     .get_function<void(void* const*, std::size_t, std::size_t)>(symbol);
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        if(kernel == nullptr)
+            MIGRAPHX_THROW("cpu::jit: kernel " + symbol + " is not loaded");
+        std::vector<void*> ptrs(args.size());
+        std::transform(args.begin(), args.end(), ptrs.begin(), [](const argument& arg) {
+            return static_cast<void*>(arg.data());
+        });
+        ctx.bulk_execute(global, grain, [&](std::size_t start, std::size_t end) {
+            kernel(ptrs.data(), start, end);
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const jit_kernel& x)
+    {
+        os << x.name() << "[symbol=" << x.symbol << "]";
+        return os;
+    }
+};
+MIGRAPHX_REGISTER_OP(jit_kernel);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -49,6 +49,7 @@
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/jit.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
@@ -57,6 +58,7 @@
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/env.hpp>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -65,6 +67,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_CPU_LOWERING)
+
 template <typename T>
 T zero(const T&)
 {
@@ -266,6 +270,7 @@ struct cpu_apply
 {
     module* modl;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
+    std::vector<operation> kernels{};
     instruction_ref last{};
 
     void extend_op(const std::string& op_name, const std::string& cpu_name, bool allocate = true)
@@ -347,6 +352,7 @@ struct cpu_apply
         extend_op("convolution_backwards", "dnnl::convolution_backwards");
         extend_op("dot", "dnnl::dot");
 #endif
+        extend_op("quant_convolution", "dnnl::quant_convolution");
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
         extend_op("logsoftmax", "dnnl::logsoftmax");
@@ -363,6 +369,13 @@ struct cpu_apply
     void apply()
     {
         init();
+        // Fused reductions have no reference implementation, so inline the ones that cannot be
+        // compiled before the reduction operators are lowered
+        for(auto it : iterator_for(*modl))
+        {
+            if(it->name() == "fused_reduce")
+                apply_fused_reduce(it);
+        }
         // Apply fusion matchers first
         match::find_matches(*modl,
                             fuse_match(match::gelu_erf(),
@@ -398,11 +411,58 @@ struct cpu_apply
             {
                 apply_pooling(it);
             }
+            else if(it->name() == "quant_dot")
+            {
+                apply_quant_dot(it);
+            }
+            else if(it->name() == "pointwise")
+            {
+                apply_pointwise(it);
+            }
             else if(apply_map.count(it->name()) > 0)
             {
                 apply_map.at(it->name())(it);
             }
         }
+        compile_kernels(kernels);
+    }
+
+    instruction_ref apply_pointwise(instruction_ref ins)
+    {
+        auto op = make_pointwise_kernel(
+            *ins->module_inputs().front(), to_shapes(ins->inputs()), ins->get_shape());
+        // Keep the reference implementation of the pointwise operator
+        if(not op)
+        {
+            if(enabled(MIGRAPHX_TRACE_CPU_LOWERING{}))
+            {
+                std::cout << "cpu lowering: no cpu::jit for: ";
+                modl->debug_print(ins);
+            }
+            return ins;
+        }
+        kernels.push_back(*op);
+        return replace(ins, *op);
+    }
+
+    instruction_ref apply_fused_reduce(instruction_ref ins)
+    {
+        const auto* rm = ins->module_inputs().front();
+        auto axes      = ins->get_operator().to_value()["axes"].to_vector<std::int64_t>();
+        auto op = make_reduce_kernel(*rm, axes, to_shapes(ins->inputs()), ins->get_shape());
+        if(op)
+        {
+            kernels.push_back(*op);
+            return replace(ins, *op);
+        }
+        if(enabled(MIGRAPHX_TRACE_CPU_LOWERING{}))
+        {
+            std::cout << "cpu lowering: no cpu::jit, inlining: ";
+            modl->debug_print(ins);
+        }
+        auto param_map = rm->get_ins_param_map(ins->inputs(), true);
+        auto outputs   = modl->insert_instructions(ins, rm, &param_map);
+        return modl->replace_instruction(ins, outputs.front());
     }
 
     instruction_ref apply_pow(instruction_ref ins) const
@@ -426,6 +486,24 @@ struct cpu_apply
         return ins;
     }
 
+    instruction_ref apply_quant_dot(instruction_ref ins) const
+    {
+        auto v = ins->get_operator().to_value();
+#ifndef MIGRAPHX_ENABLE_ZENDNN
+        // The int8 matmul doesn't take broadcasted inputs
+        if(std::none_of(ins->inputs().begin(), ins->inputs().end(), [](instruction_ref input) {
+               return input->get_shape().broadcasted();
+           }))
+        {
+            auto dnnl_ins = replace(ins, make_op("dnnl::quant_dot", v));
+            if(dnnl_ins != ins)
+                return dnnl_ins;
+        }
+#endif
+        // quant_dot has no reference implementation so it must always be lowered
+        return replace(ins, make_op("cpu::quant_dot", v));
+    }
+
     template <class T>
     static std::vector<T> read_scalar(instruction_ref ins)
     {
@@ -447,6 +525,23 @@ struct cpu_apply
     instruction_ref
     replace(instruction_ref ins, const operation& op, std::vector<instruction_ref> inputs) const
     {
+        // Keep the original operator when oneDNN has no implementation for these types, any other
+        // error from the operator is reported
+        auto shapes = to_shapes(inputs);
+        shapes.push_back(ins->get_shape());
+        try
+        {
+            op.compute_shape(shapes);
+        }
+        catch(const dnnl_unsupported& e)
+        {
+            if(enabled(MIGRAPHX_TRACE_CPU_LOWERING{}))
+            {
+                std::cout << "cpu lowering: " << e.what() << std::endl;
+                modl->debug_print(ins);
+            }
+            return ins;
+        }
         inputs.push_back(insert_allocation(ins, ins->get_shape()));
         return modl->replace_instruction(ins, op, inputs);
     }
@@ -53,6 +53,8 @@ struct cpu_preallocate : auto_register_op<cpu_preallocate>
     argument compute(context&, const shape&, const std::vector<argument>&) const { return data; }
     void finalize(context&, const shape&, const std::vector<shape>&) { data = argument(s); }
     lifetime get_lifetime() const { return lifetime::global; }
+    // Each execution session allocates its own buffer
+    value attributes() const { return {{"session_state", true}}; }
 };
 
 } // namespace cpu
@@ -32,6 +32,13 @@ struct dnnl_reorder : dnnl_op<dnnl_reorder, dnnl::reorder>
 {
     std::string name() const { return "dnnl::reorder"; }
 
+    value attributes() const
+    {
+        auto result       = dnnl_op::attributes();
+        result["reorder"] = true;
+        return result;
+    }
+
     shape adjust_shape(const shape& x, int, const shape&) const { return x; }
 
     shape compute_shape(const std::vector<shape>& inputs) const
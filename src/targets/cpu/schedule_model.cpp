@@ -0,0 +1,216 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/context.hpp>
+#include <memory>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct async_op
+{
+    operation op;
+    std::size_t stream = 0;
+    // Set when the op writes into its last input, so the result is known before it runs
+    bool nonblocking = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"), f(self.stream, "stream"), f(self.nonblocking, "nonblocking"));
+    }
+
+    std::string name() const { return "cpu::async"; }
+    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+
+    argument compute(migraphx::context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args) const
+    {
+        const auto& cctx = any_cast<context>(ctx);
+        if(nonblocking)
+        {
+            cctx.enqueue(stream, [this, &ctx, output_shape, args] {
+                op.compute(ctx, output_shape, args);
+            });
+            if(args.back().get_shape() == output_shape)
+                return args.back();
+            return args.back().reshape(output_shape);
+        }
+        // Tuples hold their elements directly, so they cant wait for the buffer
+        if(output_shape.type() == shape::tuple_type)
+            return cctx.run(stream, [&] { return op.compute(ctx, output_shape, args); });
+        // The buffer is filled in when the op runs on the stream, any reader is
+        // ordered after it by the stream queue, an event or finish_streams
+        auto result = std::make_shared<argument>();
+        cctx.enqueue(stream, [this, &ctx, output_shape, args, result] {
+            *result = op.compute(ctx, output_shape, args);
+        });
+        return {output_shape, [result] { return result->data(); }};
+    }
+
+    void
+    finalize(migraphx::context& ctx, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        op.finalize(ctx, output_shape, inputs);
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+
+    value attributes() const { return op.attributes(); }
+};
+
+struct record_event
+{
+    std::size_t event  = 0;
+    std::size_t stream = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.stream, "stream"));
+    }
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.record(stream, event);
+        return {};
+    }
+
+    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    {
+        ctx.create_events(event);
+    }
+
+    // The events are created in the context of each execution session
+    value attributes() const { return {{"session_state", true}}; }
+};
+
+struct wait_event
+{
+    std::size_t event  = 0;
+    std::size_t stream = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.stream, "stream"));
+    }
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.wait(stream, event);
+        return {};
+    }
+};
+
+struct finish_streams
+{
+    std::string name() const { return "cpu::finish_streams"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.finish();
+        return {};
+    }
+};
+
+MIGRAPHX_REGISTER_OP(async_op)
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+MIGRAPHX_REGISTER_OP(finish_streams)
+
+static std::size_t get_stream(instruction_ref ins)
+{
+    if(ins->name() != "cpu::async")
+        return 0;
+    return any_cast<async_op>(ins->get_operator()).stream;
+}
+
+std::size_t schedule_model::concurrency() const { return streams; }
+void schedule_model::sched(module& m, instruction_ref ins, std::size_t n) const
+{
+    // Ops that run submodules stay on the evaluating thread, the stream sync
+    // pass waits for the other streams before them
+    if(ins->name() == "@return" or not ins->module_inputs().empty())
+        return;
+    auto inputs      = ins->inputs();
+    auto shapes      = to_shapes(inputs);
+    auto nonblocking = not shapes.empty() and
+                       ins->get_operator().output_alias(shapes) == shapes.size() - 1;
+    m.replace_instruction(ins, async_op{ins->get_operator(), n, nonblocking}, inputs);
+}
+
+void schedule_model::wait(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(ins, wait_event{wait_id, get_stream(ins)});
+}
+void schedule_model::record(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(std::next(ins), record_event{wait_id, get_stream(ins)});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    return {{"cpu::allocate", 0},
+            {"cpu::preallocate", 0},
+            {"dnnl::convolution", 8},
+            {"dnnl::convolution_backwards", 8},
+            {"dnnl::quant_convolution", 8},
+            {"dnnl::pooling", 4},
+            {"dnnl::dot", 4},
+            {"dnnl::quant_dot", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static const std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,71 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/sync_streams.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+static bool needs_sync(instruction_ref ins)
+{
+    if(ins->name() == "@return" or not ins->module_inputs().empty())
+        return true;
+    if(ins->inputs().empty() or starts_with(ins->name(), "@"))
+        return false;
+    const auto& op = ins->get_operator();
+    if(not is_context_free(op))
+        return false;
+    // Views dont read their input
+    return op.output_alias(to_shapes(ins->inputs())) < 0;
+}
+
+void sync_streams::apply(module& m) const
+{
+    if(std::none_of(m.begin(), m.end(), [](const auto& ins) { return ins.name() == "cpu::async"; }))
+        return;
+    auto last = std::prev(m.end());
+    if(last->name() != "@return")
+        m.add_return({last});
+    // Skip the sync when nothing was enqueued since the last one
+    bool pending = false;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "cpu::async")
+            pending = true;
+        if(not pending or not needs_sync(ins))
+            continue;
+        m.insert_instruction(ins, make_op("cpu::finish_streams"));
+        pending = false;
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
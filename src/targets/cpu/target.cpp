@@ -33,6 +33,9 @@
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/eliminate_convert.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/fuse_pointwise.hpp>
+#include <migraphx/fuse_reduce.hpp>
 #include <migraphx/layout_nhwc.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
@@ -46,11 +49,14 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/jit.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/sync_streams.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
@@ -59,6 +65,10 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_CPU_JIT)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_SCHEDULE_PASS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_NHWC)
+
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameterReference
@@ -66,7 +76,15 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
 {
     auto& ctx = any_cast<context>(gctx);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
+    // Types oneDNN can execute natively, anything else runs in float
     unsupported_types.erase(shape::type_t::float_type);
+    unsupported_types.erase(shape::type_t::half_type);
+    unsupported_types.erase(shape::type_t::int8_type);
+    unsupported_types.erase(shape::type_t::uint8_type);
+    unsupported_types.erase(shape::type_t::int32_type);
+    // Pointwise and reduce chains are compiled into host kernels during lowering, when the host
+    // compiler is installed
+    const bool jit = not enabled(MIGRAPHX_DISABLE_CPU_JIT{}) and kernel_compiler{}.available();
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
@@ -89,12 +107,18 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             eliminate_convert{},
             dead_code_elimination{},
             simplify_algebra{},
+            enable_pass(enabled(MIGRAPHX_ENABLE_NHWC{}), layout_nhwc{}),
+            dead_code_elimination{},
             auto_contiguous{},
             simplify_reshapes{},
             eliminate_convert{},
             dead_code_elimination{},
             propagate_constant{},
             dead_code_elimination{},
+            enable_pass(jit, fuse_pointwise{}),
+            dead_code_elimination{},
+            enable_pass(jit, fuse_reduce{}),
+            dead_code_elimination{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
@@ -104,8 +128,10 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
-            write_literals{},
+            write_literals{&ctx},
             dead_code_elimination{},
+            schedule{schedule_model{ctx.nstreams()}, not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{})},
+            sync_streams{},
             memory_coloring{"cpu::allocate"},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
@@ -26,6 +26,10 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/register_op.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <algorithm>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -55,8 +59,42 @@ struct cpu_literal
 };
 MIGRAPHX_REGISTER_OP(cpu_literal);
 
+static void pack_weights(module& m, instruction_ref ins, context& ctx)
+{
+    auto op     = ins->get_operator();
+    auto inputs = ins->inputs();
+    if(std::none_of(inputs.begin(), inputs.end(), [](auto i) { return i->name() == "@literal"; }))
+        return;
+    auto info = compile(op, ctx, ins->get_shape(), to_shapes(inputs));
+    if(not info.contains("weights"))
+        return;
+    auto weights = info.at("weights");
+    auto i       = weights.at("index").to<std::size_t>();
+    auto w       = inputs.at(i);
+    if(w->name() != "@literal")
+        return;
+    auto src    = dnnl_memory_desc_from_value(weights.at("src"));
+    auto dst    = dnnl_memory_desc_from_value(weights.at("dst"));
+    auto packed = dnnl_reorder_argument(w->get_literal().get_argument(), src, dst);
+    inputs[i]   = m.add_literal(literal{packed.get_shape(), packed.data()});
+
+    auto v                   = op.to_value();
+    v["packed_weights"]      = migraphx::to_value(w->get_shape());
+    v["packed_weights_desc"] = weights.at("dst");
+    m.replace_instruction(ins, make_op(op.name(), v), inputs);
+}
+
 void write_literals::apply(module& m) const
 {
+    if(ctx != nullptr)
+    {
+        for(auto ins : iterator_for(m))
+        {
+            if(not starts_with(ins->name(), "dnnl::"))
+                continue;
+            pack_weights(m, ins, *ctx);
+        }
+    }
     for(auto ins : iterator_for(m))
     {
         if(ins->name() != "@literal")
@@ -244,12 +244,16 @@ struct hip_allocate_memory
         argument a = allocate_gpu(s);
         store_preallocated_param(ctx, id, a);
     }
+
+    // Each execution session allocates its own buffer
+    value attributes() const { return {{"session_state", true}}; }
 };
 
 struct hip_copy_literal
 {
     literal l;
     std::string id{};
+    argument data;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
@@ -264,15 +268,12 @@ struct hip_copy_literal
         return l.get_shape();
     }
 
-    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
-    {
-        return get_preallocation(ctx, id);
-    }
+    // The copy is kept in the operator so the execution sessions share it
+    argument compute(context&, const shape&, const std::vector<argument>&) const { return data; }
 
-    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    void finalize(context&, const shape&, const std::vector<shape>&)
     {
-        argument a = to_gpu(l.get_argument());
-        store_preallocated_param(ctx, id, a);
+        data = to_gpu(l.get_argument());
     }
     friend std::ostream& operator<<(std::ostream& os, const hip_copy_literal& x)
     {
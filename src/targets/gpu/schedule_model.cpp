@@ -53,6 +53,9 @@ struct record_event
     {
         ctx.create_events(event);
     }
+
+    // The events are created in the context of each execution session
+    value attributes() const { return {{"session_state", true}}; }
 };
 
 struct wait_event
@@ -49,6 +49,7 @@
 #include <migraphx/tune_axis.hpp>
 #include <migraphx/pad_calc.hpp>
 
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -245,20 +246,26 @@ struct ref_pad
     argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
     {
         assert(dyn_out.computed_shape.standard());
-        argument result{dyn_out.computed_shape};
+        auto result = argument::uninitialized(dyn_out.computed_shape);
         result.visit([&](auto output) {
             using type = typename decltype(output)::value_type;
             std::fill(output.begin(), output.end(), pad_clamp<type>(op.value));
         });
 
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
-                std::transform(
-                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
-                        return i + j;
-                    });
-                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
+            const auto& out_strides = output.get_shape().strides();
+            // The part of the output that the input is copied to
+            shape inner{output.get_shape().type(), input.get_shape().lens(), out_strides};
+            auto start = std::inner_product(
+                out_strides.begin(), out_strides.end(), op.pads.begin(), std::size_t{0});
+            shape_runs<2> runs{{inner, input.get_shape()}};
+            auto n       = runs.length();
+            auto strides = runs.strides();
+            runs.for_each([&](const auto& offsets) {
+                auto* out      = output.data() + start + offsets[0];
+                const auto* in = input.data() + offsets[1];
+                for(std::size_t k = 0; k < n; k++)
+                    out[k * strides[0]] = in[k * strides[1]];
             });
         });
 
@@ -281,7 +288,7 @@ struct ref_gemm
 
     argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        auto result = argument::uninitialized(dyn_out.computed_shape);
         visit_all(result, args[0], args[1])(
             [&](auto cmat, auto amat, auto bmat) { gemm(cmat, amat, bmat, 1.0f, 0.0f); });
         return result;
@@ -304,7 +311,7 @@ struct ref_quant_gemm
 
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        auto result = argument::uninitialized(output_shape);
         result.visit([&](auto cmat) {
             visit_all(args.at(0), args.at(1))(
                 [&](auto amat, auto bmat) { return gemm(cmat, amat, bmat, 1.0f, 0.0f); });
@@ -0,0 +1,271 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_THREAD_AFFINITY)
+
+namespace {
+
+struct pool_job
+{
+    void (*invoke)(void*, std::size_t) = nullptr;
+    void* data                         = nullptr;
+    std::atomic<std::size_t> remaining{0};
+    std::mutex m;
+    std::condition_variable cv;
+    std::exception_ptr error = nullptr;
+
+    void execute(std::size_t i)
+    {
+        try
+        {
+            invoke(data, i);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if(error == nullptr)
+                error = std::current_exception();
+        }
+        // Decrement under the lock so the job is not destroyed by the waiting
+        // thread before we are done notifying it
+        std::lock_guard<std::mutex> lock(m);
+        if(--remaining == 0)
+            cv.notify_all();
+    }
+
+    bool done() const { return remaining.load() == 0; }
+};
+
+struct pool_task
+{
+    pool_job* job = nullptr;
+    std::size_t i = 0;
+};
+
+struct task_queue
+{
+    std::mutex m;
+    std::deque<pool_task> tasks;
+};
+
+// Number of times an idle worker polls the queues before going to sleep
+constexpr std::size_t spin_count = 256;
+
+} // namespace
+
+struct thread_pool_impl
+{
+    std::vector<task_queue> queues;
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable cv;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next_queue{0};
+    bool stop = false;
+
+    thread_pool_impl(std::size_t n) : queues(n) {}
+
+    static const thread_pool_impl*& current()
+    {
+        thread_local const thread_pool_impl* result = nullptr;
+        return result;
+    }
+
+    bool is_worker() const { return current() == this; }
+
+    void push(pool_task t, std::size_t q)
+    {
+        std::lock_guard<std::mutex> lock(queues[q].m);
+        queues[q].tasks.push_back(t);
+    }
+
+    // Take from the front of our own queue, otherwise steal from the back of the others
+    bool try_pop(std::size_t self, pool_task& t)
+    {
+        const auto n = queues.size();
+        for(std::size_t k = 0; k < n; k++)
+        {
+            auto& q = queues[(self + k) % n];
+            std::lock_guard<std::mutex> lock(q.m);
+            if(q.tasks.empty())
+                continue;
+            if(k == 0)
+            {
+                t = q.tasks.front();
+                q.tasks.pop_front();
+            }
+            else
+            {
+                t = q.tasks.back();
+                q.tasks.pop_back();
+            }
+            pending--;
+            return true;
+        }
+        return false;
+    }
+
+    void worker(std::size_t self)
+    {
+        current() = this;
+        std::size_t spins = 0;
+        for(;;)
+        {
+            pool_task t;
+            if(try_pop(self, t))
+            {
+                t.job->execute(t.i);
+                spins = 0;
+                continue;
+            }
+            if(spins < spin_count)
+            {
+                spins++;
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return stop or pending.load() > 0; });
+            if(stop and pending.load() == 0)
+                return;
+            spins = 0;
+        }
+    }
+
+    void start(bool pin)
+    {
+        const std::size_t ncpus = std::max(1u, std::thread::hardware_concurrency());
+        threads.reserve(queues.size());
+        for(std::size_t i = 0; i < queues.size(); i++)
+        {
+            threads.emplace_back([this, i] { worker(i); });
+#ifdef __linux__
+            if(pin)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(i % ncpus, &set);
+                pthread_setaffinity_np(threads.back().native_handle(), sizeof(set), &set);
+            }
+#else
+            (void)pin;
+            (void)ncpus;
+#endif
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for(auto& t : threads)
+            t.join();
+    }
+
+    void run(std::size_t n, void (*invoke)(void*, std::size_t), void* data)
+    {
+        pool_job job;
+        job.invoke    = invoke;
+        job.data      = data;
+        job.remaining = n;
+        const auto first = next_queue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(m);
+            pending += n - 1;
+        }
+        for(std::size_t i = 1; i < n; i++)
+            push({&job, i}, (first + i - 1) % queues.size());
+        cv.notify_all();
+        // The calling thread takes the first task and then helps until the queues are drained
+        job.execute(0);
+        pool_task t;
+        while(not job.done() and try_pop(first, t))
+            t.job->execute(t.i);
+        std::unique_lock<std::mutex> lock(job.m);
+        job.cv.wait(lock, [&] { return job.done(); });
+        if(job.error != nullptr)
+            std::rethrow_exception(job.error);
+    }
+};
+
+thread_pool::thread_pool(std::size_t nthreads, bool pin)
+    : impl(std::make_unique<thread_pool_impl>(nthreads))
+{
+    impl->start(pin);
+}
+
+thread_pool::~thread_pool() { impl->shutdown(); }
+
+std::size_t thread_pool::size() const { return impl->threads.size(); }
+
+std::size_t thread_pool::max_concurrency() const { return size() + 1; }
+
+void thread_pool::run_impl(std::size_t n, void (*invoke)(void*, std::size_t), void* data)
+{
+    if(n == 0)
+        return;
+    if(n == 1 or size() == 0 or impl->is_worker())
+    {
+        for(std::size_t i = 0; i < n; i++)
+            invoke(data, i);
+        return;
+    }
+    impl->run(n, invoke, data);
+}
+
+thread_pool& thread_pool::global()
+{
+    // The calling thread also does work, so one less worker is needed
+    static thread_pool pool{
+        std::max<std::size_t>(
+            1, value_of(MIGRAPHX_NUM_THREADS{}, std::thread::hardware_concurrency())) -
+            1,
+        enabled(MIGRAPHX_THREAD_AFFINITY{})};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -35,6 +35,10 @@ TEST_CASE(compile_options_api_test)
         options.get_handle_ptr());
     CHECK(s_options->fast_math == false);
     CHECK(s_options->offload_copy == false);
+    CHECK(s_options->profile == nullptr);
+    options.set_profile_passes();
+    CHECK(s_options->profile != nullptr);
+    CHECK(options.get_pass_profile().find("records") != std::string::npos);
 }
 
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
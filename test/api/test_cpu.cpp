@@ -23,6 +23,8 @@
  */
 #include <migraphx/migraphx.h>
 #include <migraphx/migraphx.hpp>
+#include <algorithm>
+#include <thread>
 #include "test.hpp"
 
 TEST_CASE(load_and_run)
@@ -64,6 +66,35 @@ TEST_CASE(load_and_run_init_list)
     CHECK(bool{shapes_before.front() == outputs.front().get_shape()});
 }
 
+TEST_CASE(run_execution_sessions)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    auto expected = p.eval(pp);
+
+    std::vector<migraphx::execution_session> sessions;
+    for(int i = 0; i < 4; i++)
+        sessions.emplace_back(p);
+    std::vector<int> passed(sessions.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            auto outputs = sessions[i].eval(pp);
+            passed[i]    = outputs.size() == 1 and outputs.front() == expected.front();
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    CHECK(std::all_of(passed.begin(), passed.end(), [](int x) { return x == 1; }));
+}
+
 TEST_CASE(quantize_fp16)
 {
     auto p1        = migraphx::parse_onnx("gemm_test.onnx");
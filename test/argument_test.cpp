@@ -22,8 +22,12 @@
  * THE SOFTWARE.
  */
 #include <migraphx/argument.hpp>
+#include <migraphx/host_allocator.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <sstream>
 #include <string>
 #include "test.hpp"
@@ -231,4 +235,74 @@ TEST_CASE(argument_share)
     EXPECT(a4.data() == a3.data());
 }
 
+TEST_CASE(argument_shared_buffer)
+{
+    migraphx::shape s{migraphx::shape::int64_type, {1}};
+    auto buffer = std::make_shared<std::int64_t>(1);
+    migraphx::argument a1(s, buffer);
+    EXPECT(a1.data() == reinterpret_cast<char*>(buffer.get()));
+    auto a2 = a1; // NOLINT
+    EXPECT(a2.data() == a1.data());
+    EXPECT(a1.share().data() == a1.data());
+    EXPECT(buffer.use_count() == 3);
+}
+
+TEST_CASE(argument_null_pointer)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::argument a(s, static_cast<float*>(nullptr));
+    EXPECT(not a.empty());
+    EXPECT(a.data() == nullptr);
+}
+
+TEST_CASE(argument_zeroed)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {2, 33}};
+    migraphx::argument a{s};
+    EXPECT(reinterpret_cast<std::uintptr_t>(a.data()) % migraphx::host_buffer_alignment == 0);
+    a.visit([](auto x) { EXPECT(std::all_of(x.begin(), x.end(), [](auto i) { return i == 0; })); });
+}
+
+TEST_CASE(argument_uninitialized_gaps)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}, {4, 1}};
+    auto a = migraphx::argument::uninitialized(s);
+    EXPECT(reinterpret_cast<std::uintptr_t>(a.data()) % migraphx::host_buffer_alignment == 0);
+    std::vector<float> values = {1, 2, 3, 4};
+    a.fill(values.begin(), values.end());
+    std::vector<float> data(s.element_space());
+    std::copy(a.data(), a.data() + s.bytes(), reinterpret_cast<char*>(data.data()));
+    EXPECT(data == std::vector<float>{1, 2, 0, 0, 3, 4});
+}
+
+TEST_CASE(argument_reuses_buffers)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1000}};
+    char* p = nullptr;
+    {
+        auto a = migraphx::argument::uninitialized(s);
+        p      = a.data();
+    }
+    auto stats = migraphx::get_host_buffer_stats();
+    EXPECT(stats.pooled_bytes >= s.bytes());
+    migraphx::argument a{s};
+    EXPECT(a.data() == p);
+    EXPECT(migraphx::get_host_buffer_stats().heap_allocations == stats.heap_allocations);
+    a.visit([](auto x) { EXPECT(std::all_of(x.begin(), x.end(), [](auto i) { return i == 0; })); });
+    migraphx::release_host_buffers();
+    EXPECT(migraphx::get_host_buffer_stats().pooled_bytes == 0);
+}
+
+TEST_CASE(argument_large_buffers_not_pooled)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3 * 1024 * 1024 + 1}};
+    migraphx::release_host_buffers();
+    {
+        auto a = migraphx::argument::uninitialized(s);
+        EXPECT(reinterpret_cast<std::uintptr_t>(a.data()) % migraphx::host_buffer_alignment == 0);
+    }
+    // A large buffer goes back to the heap instead of the pools
+    EXPECT(migraphx::get_host_buffer_stats().pooled_bytes == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
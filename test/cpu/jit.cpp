@@ -0,0 +1,201 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/jit.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/fileutils.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <sys/stat.h>
+#include "test.hpp"
+
+static migraphx::module make_add_relu()
+{
+    migraphx::module m{"add_relu"};
+    migraphx::shape s{migraphx::shape::float_type};
+    auto x   = m.add_parameter("x0", s);
+    auto y   = m.add_parameter("x1", s);
+    auto add = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto r   = m.add_instruction(migraphx::make_op("relu"), add);
+    m.add_return({r});
+    return m;
+}
+
+static std::string make_add_relu_src(const migraphx::shape& s)
+{
+    auto op = migraphx::cpu::make_pointwise_kernel(make_add_relu(), {s, s}, s);
+    EXPECT(op.has_value());
+    return op->to_value()["src"].to<std::string>();
+}
+
+static std::size_t count_files(const migraphx::fs::path& dir)
+{
+    return std::distance(migraphx::fs::directory_iterator{dir},
+                         migraphx::fs::directory_iterator{});
+}
+
+static migraphx::fs::path find_object(const migraphx::fs::path& dir)
+{
+    for(const auto& e : migraphx::fs::directory_iterator{dir})
+    {
+        if(e.path().extension() == migraphx::make_shared_object_filename("").extension())
+            return e.path();
+    }
+    return {};
+}
+
+static migraphx::cpu::kernel_compiler make_compiler(const migraphx::fs::path& dir)
+{
+    migraphx::cpu::kernel_compiler compiler;
+    compiler.cache_dir = dir;
+    return compiler;
+}
+
+TEST_CASE(pointwise_codegen)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto op = migraphx::cpu::make_pointwise_kernel(make_add_relu(), {s, s}, s);
+    EXPECT(op.has_value());
+    EXPECT(op->name() == "cpu::jit");
+    auto v = op->to_value();
+    EXPECT(v["symbol"].to<std::string>() == "add_relu_kernel");
+    EXPECT(v["global"].to<std::size_t>() == 6);
+
+    migraphx::cpu::kernel_compiler compiler;
+    compiler.cache_dir = "";
+    migraphx::dynamic_loader loader{compiler.compile(v["src"].to<std::string>())};
+    auto f = loader.get_function<void(void* const*, std::size_t, std::size_t)>("add_relu_kernel");
+    std::vector<float> x = {-1, 2, -3, 4, -5, 6};
+    std::vector<float> y = {0, 1, 1, -5, 1, 1};
+    std::vector<float> z(6);
+    std::vector<void*> args = {x.data(), y.data(), z.data()};
+    f(args.data(), 0, 6);
+    EXPECT(z == std::vector<float>{0, 3, 0, 0, 0, 7});
+}
+
+TEST_CASE(pointwise_unsupported_type)
+{
+    migraphx::shape s{migraphx::shape::half_type, {2, 3}};
+    EXPECT(not migraphx::cpu::make_pointwise_kernel(make_add_relu(), {s, s}, s).has_value());
+}
+
+TEST_CASE(cache_miss_then_hit)
+{
+    migraphx::tmp_dir td{"cpu-jit-test"};
+    auto dir      = td.path / "cache";
+    auto compiler = make_compiler(dir);
+    auto src      = make_add_relu_src(migraphx::shape{migraphx::shape::float_type, {4}});
+
+    auto image = compiler.compile(src);
+    EXPECT(migraphx::fs::is_directory(dir));
+    EXPECT(count_files(dir) == 2);
+    struct stat st = {};
+    EXPECT(stat(dir.c_str(), &st) == 0);
+    EXPECT((st.st_mode & 0777) == 0700);
+
+    auto so_path = find_object(dir);
+    EXPECT(not so_path.empty());
+    auto time = migraphx::fs::last_write_time(so_path);
+
+    // A hit returns the cached shared object without writing it again
+    EXPECT(compiler.compile(src) == image);
+    EXPECT(bool{migraphx::fs::last_write_time(so_path) == time});
+    EXPECT(count_files(dir) == 2);
+
+    // A different kernel is a miss
+    compiler.compile(make_add_relu_src(migraphx::shape{migraphx::shape::int32_type, {4}}));
+    EXPECT(count_files(dir) == 4);
+}
+
+TEST_CASE(cache_key_collision)
+{
+    migraphx::tmp_dir td{"cpu-jit-test"};
+    auto dir      = td.path / "cache";
+    auto compiler = make_compiler(dir);
+    auto src      = make_add_relu_src(migraphx::shape{migraphx::shape::float_type, {4}});
+    auto image    = compiler.compile(src);
+
+    auto so_path  = find_object(dir);
+    auto src_path = so_path;
+    src_path.replace_extension(".cpp");
+    std::string other = "other kernel";
+    migraphx::write_buffer(src_path, other.data(), other.size());
+
+    // The stored key no longer matches, so the kernel is compiled again
+    EXPECT(compiler.compile(src) == image);
+    EXPECT(migraphx::read_string(src_path) != other);
+    EXPECT(count_files(dir) == 2);
+}
+
+TEST_CASE(cache_shared_dir)
+{
+    migraphx::tmp_dir td{"cpu-jit-test"};
+    auto dir = td.path / "cache";
+    migraphx::fs::create_directories(dir);
+    migraphx::fs::permissions(dir, migraphx::fs::perms::all);
+    auto compiler = make_compiler(dir);
+    auto src      = make_add_relu_src(migraphx::shape{migraphx::shape::float_type, {4}});
+
+    // A directory other users can write to is not used
+    EXPECT(not compiler.compile(src).empty());
+    EXPECT(count_files(dir) == 0);
+}
+
+TEST_CASE(cache_readable_dir)
+{
+    migraphx::tmp_dir td{"cpu-jit-test"};
+    auto dir = td.path / "cache";
+    migraphx::fs::create_directories(dir);
+    migraphx::fs::permissions(dir,
+                              migraphx::fs::perms::owner_all | migraphx::fs::perms::group_read |
+                                  migraphx::fs::perms::others_read);
+    auto compiler = make_compiler(dir);
+    auto src      = make_add_relu_src(migraphx::shape{migraphx::shape::float_type, {4}});
+
+    // A directory others can only read is restricted to the owner, and then used
+    compiler.compile(src);
+    EXPECT(count_files(dir) == 2);
+    struct stat st = {};
+    EXPECT(stat(dir.c_str(), &st) == 0);
+    EXPECT((st.st_mode & 0777) == 0700);
+}
+
+TEST_CASE(missing_compiler)
+{
+    migraphx::tmp_dir td{"cpu-jit-test"};
+    migraphx::cpu::kernel_compiler compiler;
+    compiler.compiler  = td.path / "missing-c++";
+    compiler.cache_dir = td.path / "cache";
+    EXPECT(not compiler.available());
+    auto src = make_add_relu_src(migraphx::shape{migraphx::shape::float_type, {4}});
+    EXPECT(test::throws([&] { compiler.compile(src); }));
+
+    compiler.compiler = "missing-c++";
+    EXPECT(not compiler.available());
+    EXPECT(migraphx::cpu::kernel_compiler{}.available());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
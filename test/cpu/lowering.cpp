@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <test.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+
+static std::vector<std::string> names(const migraphx::program& p)
+{
+    std::vector<std::string> result;
+    for(const auto& ins : *p.get_main_module())
+        result.push_back(ins.name());
+    return result;
+}
+
+static migraphx::argument run(migraphx::program p, const std::string& target)
+{
+    p.compile(migraphx::make_target(target));
+    migraphx::parameter_map params;
+    for(auto&& x : p.get_parameter_shapes())
+        params[x.first] = migraphx::generate_argument(x.second);
+    return p.eval(params).back();
+}
+
+static bool verify_with_ref(const migraphx::program& p)
+{
+    auto ref    = run(p, "ref");
+    auto result = run(p, "cpu");
+    return migraphx::verify::verify_rms_range(result.get<float>(), ref.get<float>());
+}
+
+TEST_CASE(lower_dot)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", {migraphx::shape::float_type, {2, 3}});
+    auto b   = mm->add_parameter("b", {migraphx::shape::float_type, {3, 4}});
+    mm->add_instruction(migraphx::make_op("dot"), a, b);
+
+    auto cp = p;
+    cp.compile(migraphx::make_target("cpu"));
+    EXPECT(migraphx::contains(names(cp), "dnnl::dot"));
+    EXPECT(verify_with_ref(p));
+}
+
+TEST_CASE(lower_unsupported_type)
+{
+    // oneDNN has no int8 lrn, so the reference operator is kept
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int8_type, {1, 5, 2, 2}});
+    mm->add_instruction(
+        migraphx::make_op("lrn", {{"alpha", 0.0001}, {"beta", 0.75}, {"bias", 1}, {"size", 5}}),
+        x);
+
+    auto cp = p;
+    cp.compile(migraphx::make_target("cpu"));
+    auto cnames = names(cp);
+    EXPECT(migraphx::contains(cnames, "lrn"));
+    EXPECT(not migraphx::contains(cnames, "dnnl::lrn"));
+    EXPECT(run(p, "cpu") == run(p, "ref"));
+}
+
+TEST_CASE(unsupported_error)
+{
+    migraphx::shape s{migraphx::shape::int8_type, {1, 5, 2, 2}};
+    auto op = migraphx::make_op("dnnl::lrn", {{"alpha", 0.0001}, {"beta", 0.75}, {"size", 5}});
+    EXPECT(test::throws<migraphx::cpu::dnnl_unsupported>([&] { op.compute_shape({s, s}); }));
+}
+
+TEST_CASE(shape_error)
+{
+    // Errors other than a missing implementation are not reported as unsupported
+    migraphx::shape a{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape b{migraphx::shape::float_type, {4, 5}};
+    migraphx::shape c{migraphx::shape::float_type, {2, 5}};
+    auto op          = migraphx::make_op("dnnl::dot");
+    bool unsupported = false;
+    EXPECT(test::throws<migraphx::exception>([&] {
+        try
+        {
+            op.compute_shape({a, b, c});
+        }
+        catch(const migraphx::cpu::dnnl_unsupported&)
+        {
+            unsupported = true;
+            throw;
+        }
+    }));
+    EXPECT(not unsupported);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,306 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/sync_streams.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/schedule.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include "test.hpp"
+
+struct nop_context_op
+{
+    std::string name() const { return "test::nop_context"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(migraphx::cpu::context&,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        return args.front();
+    }
+};
+
+struct alias_last_op
+{
+    std::string name() const { return "test::alias_last"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.back();
+    }
+    migraphx::argument compute(migraphx::cpu::context&,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        return args.back();
+    }
+    std::ptrdiff_t output_alias(const std::vector<migraphx::shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+static std::vector<std::string> names(const migraphx::module& m)
+{
+    std::vector<std::string> result;
+    for(const auto& ins : m)
+        result.push_back(ins.name());
+    return result;
+}
+
+// A branch heavy enough for the schedule pass to put on its own stream
+static migraphx::instruction_ref add_branch(migraphx::module& m, migraphx::instruction_ref x)
+{
+    auto y = m.add_instruction(nop_context_op{}, x);
+    return m.add_instruction(nop_context_op{}, y);
+}
+
+static std::size_t count(const migraphx::module& m, const std::string& name)
+{
+    return std::count_if(m.begin(), m.end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+TEST_CASE(sched_async)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x    = m.add_parameter("x", s);
+    auto y    = m.add_parameter("y", s);
+    auto add  = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto copy = m.add_instruction(alias_last_op{}, add, y);
+    m.add_return({copy});
+
+    migraphx::cpu::schedule_model model{2};
+    model.sched(m, add, 1);
+    model.sched(m, copy, 0);
+    model.sched(m, std::prev(m.end()), 1);
+
+    EXPECT(add->name() == "cpu::async");
+    auto v = add->get_operator().to_value();
+    EXPECT(v["op"]["name"].to<std::string>() == "add");
+    EXPECT(v["stream"].to<std::size_t>() == 1);
+    EXPECT(not v["nonblocking"].to<bool>());
+    EXPECT(add->get_shape() == s);
+
+    EXPECT(copy->name() == "cpu::async");
+    EXPECT(copy->get_operator().to_value()["nonblocking"].to<bool>());
+    EXPECT(copy->get_operator().output_alias(to_shapes(copy->inputs())) == 1);
+
+    // The return is left for sync_streams
+    EXPECT(std::prev(m.end())->name() == "@return");
+}
+
+TEST_CASE(sched_events)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x   = m.add_parameter("x", s);
+    auto a   = m.add_instruction(migraphx::make_op("relu"), x);
+    auto b   = m.add_instruction(migraphx::make_op("tanh"), x);
+    auto add = m.add_instruction(migraphx::make_op("add"), a, b);
+    m.add_return({add});
+
+    migraphx::cpu::schedule_model model{2};
+    model.sched(m, a, 1);
+    model.sched(m, b, 0);
+    model.sched(m, add, 0);
+    model.record(m, a, 0);
+    model.wait(m, add, 0);
+
+    auto record = std::next(a);
+    EXPECT(record->name() == "cpu::record_event");
+    EXPECT(record->get_operator().to_value()["stream"].to<std::size_t>() == 1);
+    auto wait = std::prev(add);
+    EXPECT(wait->name() == "cpu::wait_event");
+    EXPECT(wait->get_operator().to_value()["stream"].to<std::size_t>() == 0);
+    EXPECT(wait->get_operator().to_value()["event"].to<std::size_t>() == 0);
+}
+
+TEST_CASE(sched_weight)
+{
+    migraphx::cpu::schedule_model model{2};
+    EXPECT(model.concurrency() == 2);
+    auto alloc =
+        migraphx::make_op("cpu::allocate", {{"shape", migraphx::to_value(migraphx::shape{})}});
+    EXPECT(model.weight(alloc) == 0);
+    EXPECT(model.weight(migraphx::make_op("add")) == 2);
+}
+
+TEST_CASE(sync_before_return)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x  = m.add_parameter("x", s);
+    auto a  = add_branch(m, x);
+    auto b  = add_branch(m, x);
+    auto ab = m.add_instruction(nop_context_op{}, a, b);
+    m.add_return({ab});
+    migraphx::run_passes(
+        m, {migraphx::schedule{migraphx::cpu::schedule_model{2}}, migraphx::cpu::sync_streams{}});
+
+    EXPECT(count(m, "cpu::async") == 5);
+    EXPECT(count(m, "cpu::finish_streams") == 1);
+    EXPECT(std::prev(m.end(), 2)->name() == "cpu::finish_streams");
+}
+
+TEST_CASE(sync_before_reader)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x     = m.add_parameter("x", s);
+    auto a     = add_branch(m, x);
+    auto b     = add_branch(m, x);
+    auto ab    = m.add_instruction(nop_context_op{}, a, b);
+    auto slice = m.add_instruction(
+        migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {2}}}), ab);
+    auto neg = m.add_instruction(migraphx::make_op("neg"), slice);
+    m.add_return({neg});
+    migraphx::run_passes(
+        m, {migraphx::schedule{migraphx::cpu::schedule_model{2}}, migraphx::cpu::sync_streams{}});
+
+    // The view doesnt read its input, so the streams finish before the neg
+    EXPECT(std::prev(neg)->name() == "cpu::finish_streams");
+    EXPECT(std::prev(slice)->name() != "cpu::finish_streams");
+    // Nothing was enqueued since, so the return doesnt sync again
+    EXPECT(count(m, "cpu::finish_streams") == 1);
+}
+
+TEST_CASE(sync_without_streams)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x = m.add_parameter("x", s);
+    auto a = m.add_instruction(nop_context_op{}, x);
+    m.add_return({a});
+    auto expected = names(m);
+    migraphx::run_passes(
+        m, {migraphx::schedule{migraphx::cpu::schedule_model{1}}, migraphx::cpu::sync_streams{}});
+    EXPECT(names(m) == expected);
+}
+
+TEST_CASE(context_streams)
+{
+    migraphx::cpu::context ctx{3};
+    EXPECT(ctx.nstreams() == 3);
+    EXPECT(migraphx::cpu::context{0}.nstreams() == 1);
+    EXPECT(test::throws([&] { ctx.enqueue(3, [] {}); }));
+
+    // Work on a stream runs in order
+    std::vector<int> order;
+    for(int i = 0; i < 8; i++)
+        ctx.enqueue(1, [&order, i] { order.push_back(i); });
+    ctx.finish();
+    EXPECT(order == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7});
+
+    // Stream 0 runs inline
+    bool inline_run = false;
+    ctx.enqueue(0, [&] { inline_run = true; });
+    EXPECT(inline_run);
+
+    auto r = ctx.run(2, [] { return migraphx::argument{migraphx::shape{}}; });
+    EXPECT(r.get_shape() == migraphx::shape{});
+}
+
+TEST_CASE(context_events)
+{
+    migraphx::cpu::context ctx{3};
+    ctx.create_events(0);
+    std::promise<void> start;
+    auto started = start.get_future().share();
+    std::mutex m;
+    std::vector<int> order;
+    auto push = [&](int i) {
+        std::lock_guard<std::mutex> lock(m);
+        order.push_back(i);
+    };
+    ctx.enqueue(1, [&, started] {
+        started.wait();
+        push(1);
+    });
+    ctx.record(1, 0);
+    ctx.wait(2, 0);
+    ctx.enqueue(2, [&] { push(2); });
+    start.set_value();
+    ctx.finish();
+    EXPECT(order == std::vector<int>{1, 2});
+
+    // Events can be recorded again on the next run
+    ctx.record(1, 0);
+    ctx.wait(0, 0);
+    ctx.finish();
+    EXPECT(test::throws([&] { ctx.record(1, 1); }));
+}
+
+TEST_CASE(context_error)
+{
+    migraphx::cpu::context ctx{2};
+    std::atomic<bool> after{false};
+    ctx.enqueue(1, [] { throw std::runtime_error("stream error"); });
+    ctx.enqueue(1, [&] { after = true; });
+    EXPECT(test::throws<std::runtime_error>([&] { ctx.finish(); }, "stream error"));
+    // The queue keeps draining and the error is only reported once
+    EXPECT(after.load());
+    ctx.finish();
+}
+
+TEST_CASE(async_dispatch)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x   = m.add_parameter("x", s);
+    auto nop = m.add_instruction(nop_context_op{}, x);
+    migraphx::cpu::schedule_model{2}.sched(m, nop, 1);
+
+    migraphx::context ctx = migraphx::cpu::context{2};
+    auto& cctx            = migraphx::any_cast<migraphx::cpu::context>(ctx);
+    std::promise<void> start;
+    auto started   = start.get_future().share();
+    bool timed_out = false;
+    cctx.enqueue(1, [&, started] {
+        timed_out = started.wait_for(std::chrono::seconds{10}) == std::future_status::timeout;
+    });
+
+    // The op is queued behind the blocked stream, so it returns before running
+    auto arg    = migraphx::generate_argument(s);
+    auto result = nop->get_operator().compute(ctx, s, {arg});
+    start.set_value();
+    cctx.finish();
+    EXPECT(not timed_out);
+    EXPECT(result.get_shape() == s);
+    EXPECT(result.data() == arg.data());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,193 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <test.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+
+static const migraphx::shape conv_weights{migraphx::shape::float_type, {16, 8, 3, 3}};
+static const migraphx::shape gemm_weights{migraphx::shape::float_type, {64, 32}};
+
+static migraphx::instruction_ref
+add_weights(migraphx::module* mm, const migraphx::shape& s, bool literal)
+{
+    if(literal)
+        return mm->add_literal(migraphx::generate_literal(s, 1));
+    return mm->add_parameter("w", s);
+}
+
+static migraphx::program make_conv(bool literal)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {1, 8, 14, 14}});
+    auto w   = add_weights(mm, conv_weights, literal);
+    mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+    return p;
+}
+
+static migraphx::program make_gemm(bool literal)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", {migraphx::shape::float_type, {4, 64}});
+    auto b   = add_weights(mm, gemm_weights, literal);
+    mm->add_instruction(migraphx::make_op("dot"), a, b);
+    return p;
+}
+
+static bool has_packed_weights(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        if(not migraphx::starts_with(ins.name(), "dnnl::"))
+            return false;
+        auto v = ins.get_operator().to_value();
+        return not v.at("packed_weights").is_null();
+    });
+}
+
+static migraphx::parameter_map make_params(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    for(auto&& x : p.get_parameter_shapes())
+        params[x.first] = migraphx::generate_argument(x.second);
+    return params;
+}
+
+static bool verify_args(const migraphx::argument& result, const migraphx::argument& expected)
+{
+    return migraphx::verify::verify_rms_range(result.get<float>(), expected.get<float>());
+}
+
+// The weights of the first program are a literal, which is packed when it is
+// compiled, and a parameter of the second, which is not
+static bool
+verify_packed(migraphx::program packed, migraphx::program unpacked, const migraphx::shape& ws)
+{
+    auto params = make_params(unpacked);
+    params["w"] = migraphx::generate_literal(ws, 1).get_argument();
+    packed.compile(migraphx::make_target("cpu"));
+    unpacked.compile(migraphx::make_target("cpu"));
+    EXPECT(not has_packed_weights(unpacked));
+
+    auto result = packed.eval(params).back();
+    return verify_args(result, unpacked.eval(params).back());
+}
+
+TEST_CASE(prepacked_convolution)
+{
+    EXPECT(verify_packed(make_conv(true), make_conv(false), conv_weights));
+}
+
+TEST_CASE(prepacked_gemm)
+{
+    EXPECT(verify_packed(make_gemm(true), make_gemm(false), gemm_weights));
+}
+
+TEST_CASE(prepacked_save_load)
+{
+    for(auto p : {make_conv(true), make_gemm(true)})
+    {
+        auto params = make_params(p);
+        p.compile(migraphx::make_target("cpu"));
+        auto loaded = migraphx::load_buffer(migraphx::save_buffer(p));
+        EXPECT(has_packed_weights(loaded) == has_packed_weights(p));
+
+        EXPECT(verify_args(loaded.eval(params).back(), p.eval(params).back()));
+    }
+}
+
+TEST_CASE(packed_layout_mismatch)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 14, 14}};
+    migraphx::shape os{migraphx::shape::float_type, {1, 16, 14, 14}};
+    std::vector<migraphx::shape> inputs = {xs, conv_weights, os};
+    migraphx::context ctx               = migraphx::cpu::context{};
+    auto op   = migraphx::make_op("dnnl::convolution", {{"padding", {1, 1}}});
+    auto info = op.compile(ctx, os, inputs);
+    // Nothing is packed when the primitive runs on the plain layout
+    if(not info.contains("weights"))
+        return;
+
+    // The descriptor of the plain layout stands in for weights packed for
+    // another primitive, so they have to be reordered on the first call
+    auto v                   = op.to_value();
+    v["packed_weights"]      = migraphx::to_value(conv_weights);
+    v["packed_weights_desc"] = info.at("weights").at("src");
+    auto packed              = migraphx::make_op("dnnl::convolution", v);
+    op.finalize(ctx, os, inputs);
+    packed.finalize(ctx, os, inputs);
+
+    auto x        = migraphx::generate_argument(xs);
+    auto w        = migraphx::generate_argument(conv_weights, 1);
+    auto expected = op.compute(ctx, os, {x, w, migraphx::argument{os}});
+    auto result   = packed.compute(ctx, os, {x, w, migraphx::argument{os}});
+    EXPECT(verify_args(result, expected));
+    // Later calls reuse the reordered weights
+    result = packed.compute(ctx, os, {x, w, migraphx::argument{os}});
+    EXPECT(verify_args(result, expected));
+}
+
+TEST_CASE(packed_desc_fields)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 14, 14}};
+    migraphx::shape os{migraphx::shape::float_type, {1, 16, 14, 14}};
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto op               = migraphx::make_op("dnnl::convolution", {{"padding", {1, 1}}});
+    auto info             = op.compile(ctx, os, {xs, conv_weights, os});
+    if(not info.contains("weights"))
+        return;
+
+    // The descriptor is saved field by field, and reads back to the same one
+    auto dst = info.at("weights").at("dst");
+    EXPECT(dst.contains("dims"));
+    EXPECT(dst.contains("inner_blks"));
+    auto desc = migraphx::cpu::dnnl_memory_desc_from_value(dst);
+    EXPECT(migraphx::cpu::dnnl_memory_desc_to_value(desc) == dst);
+
+    auto bad       = dst;
+    bad["strides"] = migraphx::value::array{};
+    EXPECT(test::throws([&] { migraphx::cpu::dnnl_memory_desc_from_value(bad); }));
+}
+
+TEST_CASE(packed_missing_desc)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 14, 14}};
+    migraphx::shape os{migraphx::shape::float_type, {1, 16, 14, 14}};
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto op               = migraphx::make_op(
+        "dnnl::convolution",
+        {{"padding", {1, 1}}, {"packed_weights", migraphx::to_value(conv_weights)}});
+    EXPECT(test::throws([&] { op.finalize(ctx, os, {xs, conv_weights, os}); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
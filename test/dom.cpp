@@ -23,6 +23,9 @@
  */
 #include <migraphx/dom_info.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/erase.hpp>
+#include <migraphx/ranges.hpp>
+#include <unordered_set>
 #include <basic_ops.hpp>
 #include <test.hpp>
 
@@ -49,4 +52,87 @@ TEST_CASE(dom1)
     EXPECT(not dom.strictly_dominate(ins4, ins5));
 }
 
+TEST_CASE(dom_transitive)
+{
+    migraphx::module mm;
+    auto ins1 = mm.add_parameter("entry", {migraphx::shape::float_type});
+    auto ins2 = mm.add_instruction(pass_op{}, ins1);
+    auto ins3 = mm.add_instruction(pass_op{}, ins2);
+    auto ins4 = mm.add_instruction(pass_op{}, ins1);
+    auto ins5 = mm.add_instruction(pass_op{}, ins3, ins4);
+
+    auto dom = migraphx::compute_dominator(mm);
+    EXPECT(bool{dom.ins2idom.at(ins5) == ins1});
+    EXPECT(dom.strictly_dominate(ins1, ins5));
+    EXPECT(not dom.strictly_dominate(ins2, ins5));
+    EXPECT(not dom.strictly_dominate(ins4, ins5));
+    EXPECT(not dom.strictly_dominate(ins5, ins5));
+}
+
+TEST_CASE(dom_multiple_roots)
+{
+    migraphx::module mm;
+    auto x    = mm.add_parameter("x", {migraphx::shape::float_type});
+    auto y    = mm.add_parameter("y", {migraphx::shape::float_type});
+    auto ins1 = mm.add_instruction(pass_op{}, x);
+    auto ins2 = mm.add_instruction(pass_op{}, ins1, y);
+    auto ins3 = mm.add_instruction(pass_op{}, ins2);
+
+    auto dom = migraphx::compute_dominator(mm);
+    EXPECT(dom.strictly_dominate(x, ins1));
+    EXPECT(not dom.strictly_dominate(x, ins2));
+    EXPECT(not dom.strictly_dominate(y, ins2));
+    EXPECT(not dom.strictly_dominate(ins1, ins3));
+    EXPECT(dom.strictly_dominate(ins2, ins3));
+    EXPECT(not migraphx::contains(dom.ins2idom, ins2));
+}
+
+// Compare against the dominator sets, where an instruction is dominated by itself and by every
+// instruction that dominates all of its inputs
+TEST_CASE(dom_dominator_sets)
+{
+    migraphx::module mm;
+    std::vector<migraphx::instruction_ref> inss;
+    inss.push_back(mm.add_parameter("x", {migraphx::shape::float_type}));
+    inss.push_back(mm.add_parameter("y", {migraphx::shape::float_type}));
+    std::size_t seed = 7;
+    auto next        = [&](std::size_t n) {
+        seed = (seed * 1103515245 + 12345) % 2147483648;
+        return seed % n;
+    };
+    for(std::size_t i = 0; i < 100; i++)
+    {
+        std::vector<migraphx::instruction_ref> args;
+        auto nargs = 1 + next(3);
+        for(std::size_t j = 0; j < nargs; j++)
+            args.push_back(inss[inss.size() - 1 - next(std::min<std::size_t>(inss.size(), 8))]);
+        inss.push_back(mm.add_instruction(pass_op{}, args));
+    }
+
+    std::unordered_map<migraphx::instruction_ref, std::unordered_set<migraphx::instruction_ref>>
+        doms;
+    for(auto ins : inss)
+    {
+        auto inputs = ins->inputs();
+        if(not inputs.empty())
+        {
+            doms[ins] = doms[inputs.front()];
+            for(auto input : inputs)
+                migraphx::erase_if(doms[ins],
+                                   [&](auto x) { return not migraphx::contains(doms[input], x); });
+        }
+        doms[ins].insert(ins);
+    }
+
+    auto dom = migraphx::compute_dominator(mm);
+    for(auto x : inss)
+    {
+        for(auto y : inss)
+        {
+            bool expected = x != y and migraphx::contains(doms[y], x);
+            EXPECT(dom.strictly_dominate(x, y) == expected);
+        }
+    }
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
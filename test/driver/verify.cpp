@@ -0,0 +1,176 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/pass.hpp>
+#include <migraphx/ranges.hpp>
+#include <cmath>
+#include <sstream>
+#include <test.hpp>
+
+struct swap_pass
+{
+    std::string op;
+    std::string replacement;
+    std::string name() const { return "swap_pass"; }
+    void apply(migraphx::module& m) const
+    {
+        for(auto ins : migraphx::iterator_for(m))
+        {
+            if(ins->name() == op)
+                m.replace_instruction(ins, migraphx::make_op(replacement), ins->inputs());
+        }
+    }
+};
+
+// Evaluates the program like ref, except that tanh computes a sigmoid. Counts the compiles.
+struct bad_target
+{
+    std::shared_ptr<std::size_t> compiles = std::make_shared<std::size_t>(0);
+    std::string name() const { return "bad"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        (*compiles)++;
+        return {swap_pass{"tanh", "sigmoid"}};
+    }
+    migraphx::context get_context() const { return migraphx::make_target("ref").get_context(); }
+};
+
+struct cout_redirect
+{
+    cout_redirect()                     = delete;
+    cout_redirect(const cout_redirect&) = delete;
+    template <class T>
+    cout_redirect(T& stream) : old(std::cout.rdbuf(stream.rdbuf()))
+    {
+    }
+    ~cout_redirect() { std::cout.rdbuf(old); }
+
+    private:
+    std::streambuf* old;
+};
+
+template <class F>
+std::string capture_output(F f)
+{
+    std::stringstream ss;
+    cout_redirect cr{ss};
+    f();
+    return ss.str();
+}
+
+static const migraphx::shape chain_shape{migraphx::shape::float_type, {8}};
+
+// A chain of n neg instructions, where the one at index bad is a tanh instead
+static migraphx::program make_chain(std::size_t n, std::size_t bad)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", chain_shape);
+    for(std::size_t i = 0; i < n; i++)
+        x = mm->add_instruction(migraphx::make_op(i == bad ? "tanh" : "neg"), x);
+    mm->add_return({x});
+    return p;
+}
+
+static migraphx::parameter_map chain_inputs()
+{
+    return {{"x", migraphx::generate_argument(chain_shape)}};
+}
+
+static void check_bisect(std::size_t n, std::size_t bad)
+{
+    auto p = make_chain(n, bad);
+    bad_target t;
+    migraphx::instruction_ref result;
+    auto output = capture_output([&] {
+        result = migraphx::driver::verify_bisect_program(p, t, {}, {}, chain_inputs());
+    });
+    const auto* mm = p.get_main_module();
+    if(bad >= n)
+    {
+        EXPECT(bool{result == mm->end()});
+        EXPECT(migraphx::contains(output, "MIGraphX verification passed successfully."));
+        EXPECT(not migraphx::contains(output, "First divergent instruction"));
+    }
+    else
+    {
+        // The parameter is the first instruction
+        EXPECT(std::distance(mm->begin(), result) == static_cast<std::ptrdiff_t>(bad + 1));
+        EXPECT(result->name() == "tanh");
+        EXPECT(migraphx::contains(output, "First divergent instruction"));
+        EXPECT(migraphx::contains(output.substr(output.rfind("First divergent instruction")),
+                                  "tanh"));
+    }
+    // Each step of the binary search compiles one truncated program
+    EXPECT(*t.compiles <= std::ceil(std::log2(n)) + 1);
+}
+
+TEST_CASE(bisect_first) { check_bisect(16, 0); }
+
+TEST_CASE(bisect_middle) { check_bisect(16, 9); }
+
+TEST_CASE(bisect_last) { check_bisect(16, 15); }
+
+TEST_CASE(bisect_passed) { check_bisect(16, 16); }
+
+TEST_CASE(bisect_single) { check_bisect(1, 0); }
+
+TEST_CASE(capture_middle)
+{
+    auto p = make_chain(16, 9);
+    bad_target t;
+    migraphx::instruction_ref result;
+    auto output = capture_output([&] {
+        result = migraphx::driver::verify_captured_program(p, t, {}, {}, chain_inputs());
+    });
+    const auto* mm = p.get_main_module();
+    EXPECT(std::distance(mm->begin(), result) == 10);
+    EXPECT(result->name() == "tanh");
+    // The instructions after the bad one diverge as well
+    EXPECT(migraphx::contains(output, "Diverged instructions: 7/16"));
+    EXPECT(migraphx::contains(output, "Input neg matches: true"));
+    // The target compiles the program once
+    EXPECT(*t.compiles == 1);
+}
+
+TEST_CASE(capture_passed)
+{
+    auto p = make_chain(16, 16);
+    bad_target t;
+    migraphx::instruction_ref result;
+    auto output = capture_output([&] {
+        result = migraphx::driver::verify_captured_program(p, t, {}, {}, chain_inputs());
+    });
+    EXPECT(bool{result == p.get_main_module()->end()});
+    EXPECT(migraphx::contains(output, "Diverged instructions: 0/16"));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -171,6 +171,57 @@ TEST_CASE(cse_test_literal)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_attributes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto t1 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        auto t2 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1}}}), x);
+        auto t3 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        m1.add_instruction(pass_op{}, t1, t2, t3);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x  = m2.add_parameter("x", s);
+        auto t1 = m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        auto t2 = m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1}}}), x);
+        m2.add_instruction(pass_op{}, t1, t2, t1);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_test_chain)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto y1 = x;
+        auto y2 = x;
+        for(int i = 0; i < 8; i++)
+        {
+            y1 = m1.add_instruction(migraphx::make_op("add"), y1, x);
+            y2 = m1.add_instruction(migraphx::make_op("add"), y2, x);
+        }
+        m1.add_instruction(pass_op{}, y1, y2);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto y = x;
+        for(int i = 0; i < 8; i++)
+            y = m2.add_instruction(migraphx::make_op("add"), y, x);
+        m2.add_instruction(pass_op{}, y, y);
+    }
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_submodule)
 {
     migraphx::shape si{migraphx::shape::int64_type};
@@ -29,6 +29,7 @@
 #include <migraphx/compile_options.hpp>
 #include <migraphx/make_op.hpp>
 #include <sstream>
+#include <thread>
 #include "test.hpp"
 #include <basic_ops.hpp>
 
@@ -91,6 +92,36 @@ struct id_ctx_final_op
     int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
 };
 
+struct counter_op
+{
+    std::shared_ptr<int> count;
+
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "counter_op"; }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        (*count)++;
+        return migraphx::literal{*count}.get_argument();
+    }
+
+    void finalize(id_target::context&, const migraphx::shape&, const std::vector<migraphx::shape>&)
+    {
+        count = std::make_shared<int>(0);
+    }
+
+    migraphx::value attributes() const { return {{"session_state", true}}; }
+
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const
+    {
+        return migraphx::shape{migraphx::shape::int32_type};
+    }
+};
+
 struct reverse_pass
 {
     std::string name() const { return "reverse_pass"; }
@@ -499,6 +530,127 @@ TEST_CASE(eval_context3)
     EXPECT(not is_shared(t.ctx, p.get_context()));
 }
 
+TEST_CASE(eval_after_get_main_module)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+
+    // Taking the module after compiling doesn't change the result, and an edit made through it is
+    // evaluated
+    mm = p.get_main_module();
+    EXPECT(p.eval({}).back() == migraphx::literal{3}.get_argument());
+    mm->replace_instruction(sum, minus_op{}, two, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{1}.get_argument());
+}
+
+TEST_CASE(execution_session_eval)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::int32_type});
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    mm->add_instruction(sum_op{}, sum, x);
+    p.compile(id_target{});
+    migraphx::parameter_map params;
+    params["x"] = migraphx::literal{4}.get_argument();
+
+    std::vector<migraphx::execution_session> sessions;
+    for(int i = 0; i < 4; i++)
+        sessions.emplace_back(p);
+    std::vector<migraphx::argument> results(sessions.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+        threads.emplace_back([&, i] { results[i] = sessions[i].eval(params).back(); });
+    for(auto& t : threads)
+        t.join();
+    auto expected = p.eval(params).back();
+    EXPECT(std::all_of(
+        results.begin(), results.end(), [&](const auto& r) { return r == expected; }));
+}
+
+TEST_CASE(execution_session_state)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    mm->add_instruction(counter_op{});
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(p.eval({}).back() == migraphx::literal{2}.get_argument());
+    // Each session has its own copy of the operator
+    migraphx::execution_session s1{p};
+    migraphx::execution_session s2{p};
+    EXPECT(s1.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(s1.eval({}).back() == migraphx::literal{2}.get_argument());
+    EXPECT(s2.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(p.eval({}).back() == migraphx::literal{3}.get_argument());
+}
+
+TEST_CASE(execution_session_returned_literal)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    mm->add_instruction(counter_op{});
+    mm->add_return({one});
+    p.compile(id_target{});
+
+    // Writing into a returned literal doesn't change the literal of the program
+    migraphx::execution_session s1{p};
+    migraphx::execution_session s2{p};
+    auto r1 = s1.eval({}).back();
+    r1.visit([](auto x) { x.front() = 5; });
+    EXPECT(s1.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(s2.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(p.eval({}).back() == migraphx::literal{1}.get_argument());
+    EXPECT(mm->begin()->get_literal() == migraphx::literal{1});
+}
+
+TEST_CASE(eval_returned_literal_view)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {2, 2}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto l   = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    auto r   = mm->add_instruction(migraphx::make_op("reshape", {{"dims", {4}}}), l);
+    mm->add_return({r});
+    p.compile(id_target{});
+
+    migraphx::literal expected{{migraphx::shape::int32_type, {4}}, {1, 2, 3, 4}};
+    auto result = p.eval({}).back();
+    result.visit([](auto x) { std::fill(x.begin(), x.end(), 0); });
+    EXPECT(p.eval({}).back() == expected.get_argument());
+}
+
+TEST_CASE(eval_fill_literal)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {3}};
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto value = mm->add_literal(7);
+    auto l     = mm->add_literal(migraphx::literal{s, {1, 2, 3}});
+    mm->add_instruction(migraphx::make_op("fill"), value, l);
+    p.compile(id_target{});
+
+    // The operator writes into a copy of the literal
+    EXPECT(p.eval({}).back() == migraphx::literal{s, {7, 7, 7}}.get_argument());
+    EXPECT(p.eval({}).back() == migraphx::literal{s, {7, 7, 7}}.get_argument());
+    EXPECT(l->get_literal() == migraphx::literal{s, {1, 2, 3}});
+}
+
+TEST_CASE(execution_session_not_compiled)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    mm->add_literal(1);
+    EXPECT(test::throws([&] { migraphx::execution_session{p}; }));
+}
+
 struct cout_redirect
 {
     cout_redirect()                     = delete;
@@ -23,6 +23,7 @@
  */
 #include <migraphx/matcher.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
 #include <test.hpp>
 #include <basic_ops.hpp>
 
@@ -1191,4 +1192,150 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+TEST_CASE(match_root_names)
+{
+    auto names1 = match::get_root_names(match::name("sum")(match::standard_shape()).bind("x"));
+    EXPECT(names1.has_value());
+    EXPECT(*names1 == std::vector<std::string>{"sum"});
+    auto names2 = match::get_root_names(match::name("sum", "pass")(match::used_once()));
+    EXPECT(names2.has_value());
+    std::sort(names2->begin(), names2->end());
+    EXPECT(*names2 == std::vector<std::string>{"pass", "sum"});
+    auto names3 = match::get_root_names(match::any_of(match::name("sum"), match::name("pass")));
+    EXPECT(not names3.has_value());
+    EXPECT(not match::get_root_names(match::standard_shape()).has_value());
+}
+
+// Replaces a neg followed by a relu with a relu, which then lets the neg before it match
+struct match_find_neg_relu
+{
+    auto matcher() const
+    {
+        return match::name("neg")(match::any_of[match::outputs()](match::name("relu")));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, migraphx::make_op("relu"), r.result->inputs());
+    }
+};
+
+TEST_CASE(match_finder_fixpoint)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2}};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        for(int i = 0; i < 16; i++)
+            x = m1.add_instruction(migraphx::make_op("neg"), x);
+        x = m1.add_instruction(migraphx::make_op("relu"), x);
+        m1.add_return({x});
+    }
+    match::find_matches_fixpoint(m1, match_find_neg_relu{});
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        for(int i = 0; i < 17; i++)
+            x = m2.add_instruction(migraphx::make_op("relu"), x);
+        m2.add_return({x});
+    }
+    EXPECT(m1 == m2);
+}
+
+// Replaces the abs input of an exp with a tanh, which is several instructions away from the relu
+// that matches after it
+struct match_find_exp_abs
+{
+    auto matcher() const { return match::name("exp")(match::arg(0)(match::name("abs").bind("x"))); }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        auto x = r.instructions["x"];
+        m.replace_instruction(x, migraphx::make_op("tanh"), x->inputs());
+    }
+};
+
+struct match_find_relu_tanh
+{
+    auto matcher() const
+    {
+        auto neg = [](auto x) { return match::name("neg")(match::arg(0)(x)); };
+        auto x   = match::name("tanh").bind("x");
+        return match::name("relu")(match::arg(0)(neg(neg(neg(neg(neg(neg(x))))))));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, r.instructions["x"]);
+    }
+};
+
+TEST_CASE(match_finder_fixpoint_far)
+{
+    // Chains of unary operators keep the relu away from the exp and the return
+    auto add_chain = [](migraphx::module& m, const std::string& name, std::size_t n, auto x) {
+        for(std::size_t i = 0; i < n; i++)
+            x = m.add_instruction(migraphx::make_op(name), x);
+        return x;
+    };
+    migraphx::shape s{migraphx::shape::float_type, {2}};
+    migraphx::module m1;
+    {
+        auto x    = m1.add_parameter("x", s);
+        auto a    = m1.add_instruction(migraphx::make_op("abs"), x);
+        auto y    = add_chain(m1, "neg", 6, a);
+        auto relu = m1.add_instruction(migraphx::make_op("relu"), y);
+        auto z    = add_chain(m1, "sin", 3, relu);
+        auto e    = m1.add_instruction(migraphx::make_op("exp"), a);
+        auto w    = add_chain(m1, "cos", 3, e);
+        m1.add_return({z, w});
+    }
+    match::find_matches_fixpoint(m1, match_find_relu_tanh{}, match_find_exp_abs{});
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto t = m2.add_instruction(migraphx::make_op("tanh"), x);
+        auto z = add_chain(m2, "sin", 3, t);
+        auto e = m2.add_instruction(migraphx::make_op("exp"), t);
+        auto w = add_chain(m2, "cos", 3, e);
+        m2.add_return({z, w});
+    }
+    EXPECT(m1 == m2);
+}
+
+struct match_find_relu_to_sigmoid
+{
+    auto matcher() const { return match::name("relu"); }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, migraphx::make_op("sigmoid"), r.result->inputs());
+    }
+};
+
+struct match_find_sigmoid_to_relu
+{
+    auto matcher() const { return match::name("sigmoid"); }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, migraphx::make_op("relu"), r.result->inputs());
+    }
+};
+
+TEST_CASE(match_finder_fixpoint_no_fixpoint)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2}};
+    migraphx::module m;
+    auto x    = m.add_parameter("x", s);
+    auto relu = m.add_instruction(migraphx::make_op("relu"), x);
+    m.add_return({relu});
+    // Each round swaps the op back, so there is no fixpoint to stop at
+    EXPECT(test::throws([&] {
+        match::find_matches_fixpoint(m, match_find_relu_to_sigmoid{}, match_find_sigmoid_to_relu{});
+    }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -27,6 +27,7 @@
 #include <migraphx/generate.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/liveness.hpp>
 #include <basic_ops.hpp>
 #include <test.hpp>
 
@@ -35,6 +36,11 @@ void run_pass(migraphx::module& m)
     migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true}});
 }
 
+void run_interval_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true, true}});
+}
+
 struct allocate
 {
     migraphx::shape s{};
@@ -3805,4 +3811,84 @@ TEST_CASE(test_tuple)
     CHECK(is_disjoint({a1, a2}));
 }
 
+std::vector<std::pair<migraphx::instruction_ref, migraphx::instruction_ref>>
+find_conflicts(const migraphx::module& m)
+{
+    std::vector<std::pair<migraphx::instruction_ref, migraphx::instruction_ref>> result;
+    migraphx::liveness(m, [&](auto ins, auto live_set) {
+        if(ins->name() != "allocate")
+            return;
+        for(auto i : live_set)
+        {
+            if(i->name() == "allocate")
+                result.emplace_back(ins, i);
+        }
+    });
+    return result;
+}
+
+// A chain of layers where every layer also reads the output from a few layers back
+migraphx::module make_skip_chain(std::size_t n, std::size_t skip)
+{
+    migraphx::module m;
+    std::vector<migraphx::instruction_ref> outputs;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto a = add_alloc(m, {migraphx::shape::float_type, {8 * (1 + i % 7)}});
+        std::vector<migraphx::instruction_ref> args = {a};
+        if(not outputs.empty())
+            args.push_back(outputs.back());
+        if(outputs.size() > skip)
+            args.push_back(outputs[outputs.size() - skip - 1]);
+        outputs.push_back(m.add_instruction(pass_op{}, args));
+    }
+    return m;
+}
+
+TEST_CASE(intervals1)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    m.add_instruction(pass_op{}, a2, m1);
+    run_interval_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 192);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+}
+
+TEST_CASE(intervals_reuse)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    auto m2 = m.add_instruction(pass_op{}, a2, m1);
+    auto a3 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    m.add_instruction(pass_op{}, a3, m2);
+    run_interval_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 192);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+    CHECK(is_disjoint({a2, a3}));
+}
+
+TEST_CASE(intervals_skip_chain)
+{
+    for(std::size_t skip : {1, 2, 5})
+    {
+        auto m         = make_skip_chain(200, skip);
+        auto conflicts = find_conflicts(m);
+        CHECK(not conflicts.empty());
+        run_interval_pass(m);
+        CHECK(no_allocate(m));
+        CHECK(std::none_of(conflicts.begin(), conflicts.end(), [](const auto& pp) {
+            return is_overlap_load(pp.first, pp.second);
+        }));
+    }
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
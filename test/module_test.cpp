@@ -134,6 +134,31 @@ TEST_CASE(module_ins_clear)
     EXPECT(p1 == p2);
 }
 
+TEST_CASE(module_version)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::module m;
+    auto x   = m.add_parameter("x", s);
+    auto y   = m.add_parameter("y", s);
+    auto add = m.add_instruction(migraphx::make_op("add"), x, y);
+
+    auto v1 = m.version();
+    m.replace_instruction(add, migraphx::make_op("mul"), x, y);
+    auto v2 = m.version();
+    EXPECT(v1 != v2);
+    m.move_instruction(y, x);
+    auto v3 = m.version();
+    EXPECT(v2 != v3);
+    m.rename_parameter(x, "z");
+    EXPECT(v3 != m.version());
+
+    // A copy doesn't share the version of the module once either of them is changed
+    auto m2 = m; // NOLINT
+    m2.add_instruction(migraphx::make_op("relu"), add);
+    m.add_instruction(migraphx::make_op("relu"), add);
+    EXPECT(m.version() != m2.version());
+}
+
 TEST_CASE(module_name)
 {
     migraphx::module m1("name");
@@ -569,4 +594,91 @@ TEST_CASE(module_split3)
     EXPECT(bool{mods[2].inputs[1] == splits1.front()});
 }
 
+static bool is_ordered(const migraphx::module& m)
+{
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(not m.precedes(ins, m.end()) or m.precedes(m.end(), ins) or m.precedes(ins, ins))
+            return false;
+        auto next = std::next(ins);
+        if(next != m.end() and (not m.precedes(ins, next) or m.precedes(next, ins)))
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(module_precedes)
+{
+    migraphx::module m;
+    auto x    = m.add_parameter("x", {migraphx::shape::int64_type});
+    auto y    = m.add_parameter("y", {migraphx::shape::int64_type});
+    auto sum  = m.add_instruction(sum_op{}, x, y);
+    auto last = m.add_instruction(pass_op{}, sum);
+    EXPECT(m.precedes(x, last));
+    EXPECT(not m.precedes(last, x));
+    EXPECT(is_ordered(m));
+
+    // Repeated insertions at the same position use up the room between the ordinals
+    auto pos = last;
+    for(int i = 0; i < 1000; i++)
+        pos = m.insert_instruction(pos, pass_op{}, sum);
+    EXPECT(is_ordered(m));
+    for(int i = 0; i < 1000; i++)
+        m.insert_instruction(m.begin(), pass_op{}, x);
+    EXPECT(is_ordered(m));
+    for(int i = 0; i < 1000; i++)
+        m.add_instruction(pass_op{}, last);
+    EXPECT(is_ordered(m));
+
+    m.move_instruction(last, m.begin());
+    EXPECT(m.precedes(last, x));
+    EXPECT(is_ordered(m));
+    m.move_instruction(last, sum);
+    EXPECT(m.precedes(last, sum));
+    EXPECT(m.precedes(x, last));
+    EXPECT(is_ordered(m));
+}
+
+TEST_CASE(module_rename_parameter_order)
+{
+    migraphx::module m;
+    auto x   = m.add_parameter("x", {migraphx::shape::int64_type});
+    auto y   = m.add_parameter("y", {migraphx::shape::int64_type});
+    auto sum = m.add_instruction(sum_op{}, x, y);
+    m.add_instruction(pass_op{}, sum);
+    // Renaming keeps the position of the parameter
+    m.rename_parameter(y, "z");
+    EXPECT(m.precedes(x, y));
+    EXPECT(m.precedes(y, sum));
+    EXPECT(is_ordered(m));
+    EXPECT(bool{m.validate() == m.end()});
+}
+
+TEST_CASE(module_has_instruction)
+{
+    migraphx::module m1;
+    migraphx::module m2;
+    auto x1 = m1.add_parameter("x", {migraphx::shape::int64_type});
+    auto x2 = m2.add_parameter("x", {migraphx::shape::int64_type});
+    std::vector<migraphx::instruction_ref> inss;
+    for(int i = 0; i < 1000; i++)
+        inss.push_back(m1.add_instruction(pass_op{}, x1));
+    EXPECT(m1.has_instruction(x1));
+    EXPECT(not m1.has_instruction(x2));
+    EXPECT(not m1.has_instruction(m1.end()));
+    EXPECT(std::all_of(inss.begin(), inss.end(), [&](auto ins) {
+        return m1.has_instruction(ins) and not m2.has_instruction(ins);
+    }));
+    auto ins = inss.back();
+    m1.remove_instruction(ins);
+    EXPECT(not m1.has_instruction(ins));
+    auto copy = m1;
+    EXPECT(std::none_of(inss.begin(), inss.end(), [&](auto i) { return copy.has_instruction(i); }));
+    for(auto i : migraphx::iterator_for(copy))
+    {
+        EXPECT(copy.has_instruction(i));
+        EXPECT(not m1.has_instruction(i));
+    }
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -29,6 +29,7 @@ import onnx
 from onnx import helper
 from onnx import TensorProto
 from onnx.numpy_helper import from_array
+from onnx.external_data_helper import set_external_data
 
 
 def onnx_test(external_data=False):
@@ -2230,6 +2231,51 @@ def external_constant_test():
     return ([node], [], [y])
 
 
+def external_data_add(name, offsets, data):
+    # Writes the data file directly, so the tensors can be at any offset in it
+    location = '{}.weight'.format(name)
+    with open(location, 'wb') as f:
+        f.write(data)
+    tensors = []
+    for tensor_name, offset in zip(['a', 'b'], offsets):
+        tensor = TensorProto()
+        tensor.name = tensor_name
+        tensor.data_type = TensorProto.FLOAT
+        tensor.dims.append(4)
+        set_external_data(tensor, location, offset, 16)
+        tensors.append(tensor)
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [4])
+
+    node = onnx.helper.make_node('Add', inputs=['a', 'b'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
+@onnx_test()
+def external_data_aligned_test():
+    data = np.arange(1, 9, dtype=np.float32).tobytes()
+    return external_data_add('external_data_aligned_test', [0, 16], data)
+
+
+@onnx_test()
+def external_data_unaligned_test():
+    data = bytes(2) + np.arange(1, 9, dtype=np.float32).tobytes()
+    return external_data_add('external_data_unaligned_test', [2, 18], data)
+
+
+@onnx_test()
+def external_data_out_of_range_test():
+    data = np.arange(1, 5, dtype=np.float32).tobytes()
+    return external_data_add('external_data_out_of_range_test', [0, 8], data)
+
+
+@onnx_test()
+def external_data_offset_overflow_test():
+    data = np.arange(1, 5, dtype=np.float32).tobytes()
+    return external_data_add('external_data_offset_overflow_test',
+                             [0, 2**64 - 8], data)
+
+
 @onnx_test()
 def eyelike_default_test():
     T1 = helper.make_tensor_value_info('T1', TensorProto.FLOAT, [3, 4])
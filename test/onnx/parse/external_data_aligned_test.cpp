@@ -0,0 +1,61 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <onnx_test.hpp>
+
+static migraphx::program create_external_data_add_prog()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto a = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    auto b = mm->add_literal(migraphx::literal{s, {5, 6, 7, 8}});
+    mm->add_instruction(migraphx::make_op("add"), a, b);
+    return p;
+}
+
+static std::vector<const char*> literal_data(const migraphx::program& p)
+{
+    std::vector<const char*> result;
+    for(const auto& ins : *p.get_main_module())
+    {
+        if(ins.name() == "@literal")
+            result.push_back(ins.get_literal().data());
+    }
+    return result;
+}
+
+TEST_CASE(external_data_aligned_test)
+{
+    migraphx::program p = create_external_data_add_prog();
+
+    auto prog = optimize_onnx("external_data_aligned_test.onnx");
+    EXPECT(p == prog);
+    // Both tensors use the pages mapped from the same file, so they are as far apart as their
+    // offsets in it
+    auto data = literal_data(prog);
+    EXPECT(data.size() == 2);
+    auto distance = std::abs(data.front() - data.back());
+    EXPECT(distance == 16);
+}
@@ -0,0 +1,166 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <basic_ops.hpp>
+#include <mutex>
+#include <test.hpp>
+
+struct record_modules
+{
+    struct state
+    {
+        std::mutex m;
+        std::vector<std::string> names;
+    };
+    std::shared_ptr<state> s = std::make_shared<state>();
+
+    std::string name() const { return "record_modules"; }
+    bool is_module_local() const { return true; }
+    void apply(migraphx::module& m) const
+    {
+        std::lock_guard<std::mutex> guard(s->m);
+        s->names.push_back(m.name());
+    }
+};
+
+struct create_module_pass
+{
+    std::string name() const { return "create_module_pass"; }
+    bool is_module_local() const { return true; }
+    void apply(migraphx::module_pass_manager& mpm) const { mpm.create_module("new_module"); }
+};
+
+// Adds n submodules to the main module, which each have a nested submodule and some dead code
+static void add_submodules(migraphx::program& p, std::size_t n)
+{
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_literal(1);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto* sm  = p.create_module("sub" + std::to_string(i));
+        auto* nm  = p.create_module("nested" + std::to_string(i));
+        auto nl   = nm->add_literal(2);
+        auto nsum = nm->add_instruction(sum_op{}, nl, nl);
+        nm->add_instruction(pass_op{}, nsum);
+        nm->add_instruction(pass_op{}, nl);
+        auto sl   = sm->add_literal(3);
+        auto smod = sm->add_instruction(mod_pass_op{}, {sl}, {nm});
+        sm->add_instruction(sum_op{}, sl, sl);
+        sm->add_instruction(pass_op{}, smod);
+        x = mm->add_instruction(mod_pass_op{}, {x}, {sm});
+    }
+    mm->add_instruction(pass_op{}, x);
+}
+
+TEST_CASE(submodules_before_parents)
+{
+    migraphx::program p;
+    add_submodules(p, 16);
+    record_modules r;
+    migraphx::run_passes(p, {r});
+    const auto& names = r.s->names;
+    EXPECT(names.size() == 33);
+    EXPECT(names.back() == "main");
+    auto index = [&](const std::string& name) {
+        return std::distance(names.begin(), std::find(names.begin(), names.end(), name));
+    };
+    for(std::size_t i = 0; i < 16; i++)
+    {
+        auto si = std::to_string(i);
+        EXPECT(index("nested" + si) < index("sub" + si));
+    }
+}
+
+TEST_CASE(parallel_dead_code_elimination)
+{
+    migraphx::program p;
+    add_submodules(p, 16);
+    migraphx::run_passes(p, {migraphx::dead_code_elimination{}});
+    for(std::size_t i = 0; i < 16; i++)
+    {
+        auto si = std::to_string(i);
+        EXPECT(p.get_module("nested" + si)->size() == 2);
+        EXPECT(p.get_module("sub" + si)->size() == 3);
+    }
+}
+
+TEST_CASE(submodule_uses_parent)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_literal(1);
+    std::vector<migraphx::module_ref> mods;
+    for(std::size_t i = 0; i < 8; i++)
+    {
+        auto* sm = p.create_module("sub" + std::to_string(i));
+        auto s   = sm->add_instruction(sum_op{}, x, x);
+        sm->add_instruction(sum_op{}, s, s);
+        sm->add_instruction(pass_op{}, s);
+        mods.push_back(sm);
+    }
+    auto y = mm->add_instruction(mod_pass_op{}, {x}, mods);
+    mm->add_instruction(pass_op{}, y);
+    migraphx::run_passes(p, {migraphx::dead_code_elimination{}});
+    EXPECT(x->outputs().size() == 9);
+    EXPECT(std::all_of(mods.begin(), mods.end(), [](auto m) { return m->size() == 2; }));
+}
+
+TEST_CASE(module_local_create_module)
+{
+    migraphx::program p;
+    p.get_main_module()->add_literal(1);
+    EXPECT(test::throws([&] { migraphx::run_passes(p, {create_module_pass{}}); }));
+}
+
+TEST_CASE(profile_passes)
+{
+    migraphx::program p;
+    add_submodules(p, 4);
+    migraphx::tracer trace;
+    trace.profile = std::make_shared<migraphx::pass_profile>();
+    migraphx::run_passes(p, {migraphx::dead_code_elimination{}, record_modules{}}, trace);
+    auto records = trace.profile->get_records();
+    // 9 modules and the program for each pass
+    EXPECT(records.size() == 20);
+    auto nested = std::find_if(records.begin(), records.end(), [](const auto& r) {
+        return r.pass == "dead_code_elimination" and r.module == "nested0";
+    });
+    EXPECT(bool{nested != records.end()});
+    EXPECT(nested->instructions_before == 4);
+    EXPECT(nested->instructions_after == 2);
+    auto totals = trace.profile->get_totals();
+    EXPECT(totals.size() == 2);
+    EXPECT(std::all_of(totals.begin(), totals.end(), [](const auto& t) { return t.calls == 10; }));
+    auto v = trace.profile->to_value();
+    EXPECT(v.at("records").size() == 20);
+    EXPECT(v.at("totals").size() == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -196,4 +196,126 @@ TEST_CASE(program_copy)
     }
 }
 
+TEST_CASE(program_eval_copy)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+    mm->add_instruction(migraphx::make_op("add"), x, one);
+    p1.compile(migraphx::make_target("ref"));
+
+    migraphx::program p2 = p1;
+
+    std::vector<float> data = {1, 2, 3};
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument{s, data.data()};
+    auto r1     = p1.eval(params).back();
+    auto r2     = p2.eval(params).back();
+    std::vector<float> results_vector;
+    r1.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(results_vector == std::vector<float>{2, 3, 4});
+    EXPECT(r1 == r2);
+}
+
+TEST_CASE(program_eval_modified)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, one);
+    p.compile(migraphx::make_target("ref"));
+
+    // Add to the module with the pointer taken before the program was compiled
+    mm->add_instruction(migraphx::make_op("mul"), add, add);
+    std::vector<float> data = {1, 2, 3};
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument{s, data.data()};
+    auto result = p.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(results_vector == std::vector<float>{4, 9, 16});
+}
+
+TEST_CASE(program_eval_replaced)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+    mm->add_instruction(migraphx::make_op("add"), x, one);
+    p.compile(migraphx::make_target("ref"));
+
+    // Replace the operator without changing the number of instructions
+    auto last = std::prev(mm->end());
+    mm->replace_instruction(last, migraphx::make_op("mul"), last->inputs());
+    std::vector<float> data = {1, 2, 3};
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument{s, data.data()};
+    auto result = p.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(results_vector == std::vector<float>{1, 2, 3});
+}
+
+TEST_CASE(program_eval_submodule_replaced)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto cond = mm->add_parameter("cond", {migraphx::shape::bool_type});
+    auto x    = mm->add_parameter("x", s);
+    auto one  = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+
+    auto* then_mod = p.create_module("If_0_if");
+    auto add       = then_mod->add_instruction(migraphx::make_op("add"), x, one);
+    then_mod->add_return({add});
+    auto* else_mod = p.create_module("If_0_else");
+    auto sub       = else_mod->add_instruction(migraphx::make_op("sub"), x, one);
+    else_mod->add_return({sub});
+    auto r = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), r);
+    p.compile(migraphx::make_target("ref"));
+
+    std::vector<float> data = {1, 2, 3};
+    char c                  = 1;
+    migraphx::parameter_map params;
+    params["x"]    = migraphx::argument{s, data.data()};
+    params["cond"] = migraphx::argument{migraphx::shape{migraphx::shape::bool_type}, &c};
+    auto eval      = [&] {
+        std::vector<float> results_vector;
+        p.eval(params).back().visit(
+            [&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        return results_vector;
+    };
+    EXPECT(eval() == std::vector<float>{2, 3, 4});
+    EXPECT(eval() == std::vector<float>{2, 3, 4});
+
+    // The submodule changed since the program was finalized
+    then_mod = p.get_module("If_0_if");
+    add      = std::prev(then_mod->end(), 2);
+    then_mod->replace_instruction(add, migraphx::make_op("mul"), add->inputs());
+    EXPECT(eval() == std::vector<float>{1, 2, 3});
+}
+
+TEST_CASE(program_eval_shares_literals)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    mm->add_literal(migraphx::literal{s, {1, 2, 3}});
+    p.compile(migraphx::make_target("ref"));
+
+    auto l = std::find_if(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "@literal";
+    });
+    EXPECT(bool{l != mm->end()});
+    auto result = p.eval({}).back();
+    EXPECT(result.data() == l->get_literal().data());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
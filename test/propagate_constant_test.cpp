@@ -23,6 +23,7 @@
  */
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <basic_ops.hpp>
 #include <migraphx/make_op.hpp>
@@ -186,6 +187,81 @@ TEST_CASE(last_const)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_shared_subgraph)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+    migraphx::module m1;
+    {
+        auto l  = m1.add_literal(migraphx::literal{s, {1.0f, 2.0f, 3.0f, 4.0f}});
+        auto t  = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), l);
+        auto c  = m1.add_instruction(migraphx::make_op("contiguous"), t);
+        auto a  = m1.add_instruction(migraphx::make_op("add"), c, c);
+        auto b  = m1.add_instruction(migraphx::make_op("mul"), c, c);
+        auto x  = m1.add_parameter("x", s);
+        auto r1 = m1.add_instruction(migraphx::make_op("add"), a, x);
+        auto r2 = m1.add_instruction(migraphx::make_op("add"), b, x);
+        m1.add_return({r1, r2});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto a  = m2.add_literal(migraphx::literal{s, {2.0f, 6.0f, 4.0f, 8.0f}});
+        auto b  = m2.add_literal(migraphx::literal{s, {1.0f, 9.0f, 4.0f, 16.0f}});
+        auto x  = m2.add_parameter("x", s);
+        auto r1 = m2.add_instruction(migraphx::make_op("add"), a, x);
+        auto r2 = m2.add_instruction(migraphx::make_op("add"), b, x);
+        m2.add_return({r1, r2});
+    }
+    EXPECT(m1.sort() == m2.sort());
+}
+
+TEST_CASE(const_deep_chain)
+{
+    migraphx::module m1;
+    {
+        auto one = m1.add_literal(1);
+        auto sum = one;
+        for(int i = 0; i < 200; i++)
+            sum = m1.add_instruction(migraphx::make_op("add"), sum, one);
+        m1.add_instruction(non_const_pass_op{}, sum);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto total = m2.add_literal(201);
+        m2.add_instruction(non_const_pass_op{}, total);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(const_view)
+{
+    const std::vector<float> vec = {1, 2, 3, 4, 5, 6, 7, 8};
+    migraphx::shape s{migraphx::shape::float_type, {2, 4}};
+    migraphx::module m1;
+    const char* data = nullptr;
+    {
+        auto l     = m1.add_literal(migraphx::literal(s, vec));
+        data       = l->get_literal().data();
+        auto slice = m1.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {1}}}), l);
+        m1.add_instruction(non_const_pass_op{}, slice);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto l = m2.add_literal(
+            migraphx::literal({migraphx::shape::float_type, {1, 4}}, {1.0f, 2.0f, 3.0f, 4.0f}));
+        m2.add_instruction(non_const_pass_op{}, l);
+    }
+    EXPECT(m1 == m2);
+    // The folded slice is copied instead of sharing the memory of the sliced literal
+    EXPECT(std::prev(m1.end())->inputs().front()->get_literal().data() != data);
+}
+
 TEST_CASE(skip_ops)
 {
     const std::vector<float> vec = {1.0f, 2.0f, 1.0f, 2.0f};
@@ -21,7 +21,7 @@
 # OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 # THE SOFTWARE.
 #####################################################################################
-import migraphx, array, sys
+import migraphx, array, sys, threading
 
 
 def test_conv_relu():
@@ -83,7 +83,30 @@ def test_module():
     print(mm)
 
 
+def test_execution_session():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+    expected = p.run(params)[-1]
+
+    results = [None] * 4
+
+    def run(i):
+        s = migraphx.execution_session(p)
+        results[i] = s.run(params)[-1]
+
+    threads = [threading.Thread(target=run, args=(i, )) for i in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert all(r == expected for r in results)
+
+
 test_conv_relu()
 test_module()
+test_execution_session()
 if sys.version_info >= (3, 0):
     test_add_scalar()
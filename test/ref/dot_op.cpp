@@ -1719,3 +1719,98 @@ TEST_CASE(quant_dot_3args_batch_2)
     result.visit([&](auto output) { m.assign(output.begin(), output.end()); });
     EXPECT(migraphx::verify::verify_rms_range(m, gold));
 }
+
+template <class T, class U>
+std::vector<T> naive_dot(const std::vector<U>& a,
+                         const std::vector<U>& b,
+                         std::size_t batch,
+                         std::size_t m,
+                         std::size_t k,
+                         std::size_t n)
+{
+    std::vector<T> c(batch * m * n);
+    for(std::size_t bi = 0; bi < batch; bi++)
+    {
+        for(std::size_t i = 0; i < m; i++)
+        {
+            for(std::size_t j = 0; j < n; j++)
+            {
+                T s = 0;
+                for(std::size_t kk = 0; kk < k; kk++)
+                    s += T(a[bi * m * k + i * k + kk]) * T(b[bi * k * n + kk * n + j]);
+                c[bi * m * n + i * n + j] = s;
+            }
+        }
+    }
+    return c;
+}
+
+TEST_CASE(dot_multiple_blocks_test)
+{
+    // Larger than a single cache block in every dimension
+    const std::size_t batch = 2;
+    const std::size_t m     = 70;
+    const std::size_t k     = 300;
+    const std::size_t n     = 130;
+    migraphx::program p;
+
+    auto* mm = p.get_main_module();
+    std::vector<float> a(batch * m * k);
+    std::vector<float> b(batch * k * n);
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 5) - 2;
+    auto al = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {batch, m, k}}, a});
+    // Store B transposed so the gemm reads it through strides
+    std::vector<float> bt(b.size());
+    for(std::size_t bi = 0; bi < batch; bi++)
+    {
+        for(std::size_t i = 0; i < k; i++)
+        {
+            for(std::size_t j = 0; j < n; j++)
+                bt[bi * k * n + j * k + i] = b[bi * k * n + i * n + j];
+        }
+    }
+    auto bl = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {batch, n, k}}, bt});
+    auto tbl =
+        mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 1}}}), bl);
+    mm->add_instruction(migraphx::make_op("dot"), al, tbl);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    auto gold = naive_dot<float>(a, b, batch, m, k, n);
+    EXPECT(results_vector == gold);
+}
+
+TEST_CASE(quant_dot_broadcast_batch_test)
+{
+    const std::size_t batch = 3;
+    const std::size_t m     = 9;
+    const std::size_t k     = 517;
+    const std::size_t n     = 11;
+    migraphx::program p;
+
+    auto* mm = p.get_main_module();
+    std::vector<int8_t> a(m * k);
+    std::vector<int8_t> b(batch * k * n);
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = int8_t(int(i % 255) - 127);
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = int8_t(int(i % 253) - 126);
+    auto al = mm->add_literal(migraphx::literal{{migraphx::shape::int8_type, {m, k}}, a});
+    auto bal = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", {batch, m, k}}}), al);
+    auto bl = mm->add_literal(migraphx::literal{{migraphx::shape::int8_type, {batch, k, n}}, b});
+    mm->add_instruction(migraphx::make_op("quant_dot"), bal, bl);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<int32_t> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<int8_t> ba;
+    for(std::size_t bi = 0; bi < batch; bi++)
+        ba.insert(ba.end(), a.begin(), a.end());
+    auto gold = naive_dot<int32_t>(ba, b, batch, m, k, n);
+    EXPECT(results_vector == gold);
+}
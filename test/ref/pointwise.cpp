@@ -27,6 +27,7 @@
 #include <migraphx/program.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
+#include <numeric>
 
 #include <test.hpp>
 
@@ -49,3 +50,42 @@ TEST_CASE(pointwise_test)
     std::vector<float> gold = {0, 2, 4};
     EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
 }
+
+TEST_CASE(pointwise_blocks_test)
+{
+    // Enough elements for several blocks, with a transposed and a broadcasted input
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {100, 97}};
+    migraphx::shape bs{migraphx::shape::float_type, {97}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0);
+    std::vector<float> bdata(bs.elements());
+    std::iota(bdata.begin(), bdata.end(), 1);
+    migraphx::shape ts{migraphx::shape::float_type, {97, 100}};
+    auto l1 = mm->add_literal(migraphx::literal{ts, data});
+    auto l2 = mm->add_literal(migraphx::literal{bs, bdata});
+    auto t1 = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), l1);
+    auto b2 =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), l2);
+    auto* pm = p.create_module("pointwise");
+    auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+    auto two = pm->add_literal(2.0f);
+    auto mul = pm->add_instruction(migraphx::make_op("mul"), x1, two);
+    auto one = pm->add_literal(1.0f);
+    auto sub = pm->add_instruction(migraphx::make_op("sub"), mul, x2);
+    pm->add_instruction(migraphx::make_op("add"), sub, one);
+    mm->add_instruction(migraphx::make_op("pointwise"), {t1, b2}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(s.elements());
+    for(std::size_t i = 0; i < 100; i++)
+    {
+        for(std::size_t j = 0; j < 97; j++)
+            gold[i * 97 + j] = 2 * data[j * 100 + i] - bdata[j] + 1;
+    }
+    EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
+}
@@ -26,8 +26,15 @@
 #include <migraphx/load_save.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
 
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
 
 migraphx::program create_program()
 {
@@ -79,6 +86,92 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(as_file_literals)
+{
+    std::string filename = "migraphx_program_literals.mxr";
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {3, 5}});
+    auto l1  = mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {3, 5}}));
+    auto l2  = mm->add_literal(migraphx::generate_literal({migraphx::shape::int8_type, {7}}));
+    auto l3 =
+        mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {3, 5}}, 1));
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, l3);
+    mm->add_return({mul, l2});
+    migraphx::save(p1, filename);
+    migraphx::program p2 = migraphx::load(filename);
+    migraphx::program p3 = migraphx::load_buffer(migraphx::read_buffer(filename));
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(p1.sort() == p3.sort());
+    for(const auto& ins : *p2.get_main_module())
+    {
+        if(ins.name() != "@literal")
+            continue;
+        EXPECT(reinterpret_cast<std::uintptr_t>(ins.get_literal().data()) % 64 == 0);
+    }
+}
+
+TEST_CASE(as_stream)
+{
+    migraphx::program p1 = create_program();
+    std::stringstream ss;
+    migraphx::save(p1, ss);
+    std::string buffer   = ss.str();
+    migraphx::program p2 = migraphx::load_buffer(buffer.data(), buffer.size());
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(corrupt_header)
+{
+    migraphx::program p1 = create_program();
+    std::stringstream ss;
+    migraphx::save(p1, ss);
+    const std::string buffer = ss.str();
+
+    auto load_with = [&](std::size_t field, std::uint64_t x) {
+        auto corrupt = buffer;
+        std::memcpy(&corrupt[field], &x, sizeof(x));
+        return migraphx::load_buffer(corrupt.data(), corrupt.size());
+    };
+    // Offsets of data_offset, data_size and metadata_size in the header
+    const std::size_t data_offset   = 16;
+    const std::size_t data_size     = 24;
+    const std::size_t metadata_size = 40;
+    EXPECT(test::throws([&] { load_with(data_size, std::numeric_limits<std::uint64_t>::max()); }));
+    EXPECT(
+        test::throws([&] { load_with(metadata_size, std::numeric_limits<std::uint64_t>::max()); }));
+    EXPECT(test::throws([&] { load_with(data_offset, buffer.size() + 64); }));
+    EXPECT(test::throws([&] { load_with(data_offset, 65); }));
+}
+
+TEST_CASE(buffer_matches_stream)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {3, 5}});
+    auto l1  = mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {3, 5}}));
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), x, l1)});
+    std::stringstream ss;
+    migraphx::save(p1, ss);
+    std::string stream = ss.str();
+    // Both paths write the same layout with the literals streamed into the data section
+    auto buffer = migraphx::save_buffer(p1);
+    EXPECT(std::string(buffer.begin(), buffer.end()) == stream);
+    EXPECT(p1.sort() == migraphx::load_buffer(buffer).sort());
+}
+
+TEST_CASE(as_file_unmapped)
+{
+    std::string filename = "migraphx_program_unmapped.mxr";
+    migraphx::program p1 = create_program();
+    migraphx::write_buffer(filename, migraphx::to_msgpack(p1.to_value()));
+    migraphx::program p2 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
@@ -23,6 +23,7 @@
  */
 
 #include <migraphx/shape.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/serialize.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/permutation.hpp>
@@ -1085,4 +1086,102 @@ TEST_CASE(from_4d_permutation)
     EXPECT(migraphx::find_permutation(out_shape) == permutation);
 }
 
+TEST_CASE(shape_for_each_order)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 1, 3, 4}, {1, 24, 8, 2}};
+    std::size_t n = 0;
+    migraphx::shape_for_each(s, [&](const auto& idx, std::size_t i) {
+        EXPECT(i == n);
+        EXPECT(idx == s.multi(i));
+        n++;
+    });
+    EXPECT(n == s.elements());
+}
+
+// Expands the runs into the element offsets of each shape
+template <std::size_t N>
+std::array<std::vector<std::size_t>, N> run_offsets(const std::array<migraphx::shape, N>& ss)
+{
+    std::array<std::vector<std::size_t>, N> result;
+    migraphx::shape_runs<N> runs{ss};
+    auto strides = runs.strides();
+    runs.for_each([&](const auto& offsets) {
+        for(std::size_t j = 0; j < N; j++)
+        {
+            for(std::size_t k = 0; k < runs.length(); k++)
+                result[j].push_back(offsets[j] + k * strides[j]);
+        }
+    });
+    return result;
+}
+
+template <std::size_t N>
+std::array<std::vector<std::size_t>, N> element_offsets(const std::array<migraphx::shape, N>& ss)
+{
+    std::array<std::vector<std::size_t>, N> result;
+    for(std::size_t j = 0; j < N; j++)
+    {
+        for(std::size_t i = 0; i < ss[j].elements(); i++)
+            result[j].push_back(ss[j].index(i));
+    }
+    return result;
+}
+
+TEST_CASE(shape_runs_standard)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape_runs<1> runs{{s}};
+    EXPECT(runs.length() == 24);
+    EXPECT(runs.strides()[0] == 1);
+    EXPECT(run_offsets<1>({s}) == element_offsets<1>({s}));
+}
+
+TEST_CASE(shape_runs_transposed)
+{
+    migraphx::shape out{migraphx::shape::float_type, {2, 3, 4, 5}};
+    auto in = migraphx::shape::from_permutation(
+        migraphx::shape::float_type, {2, 3, 4, 5}, {0, 2, 3, 1});
+    migraphx::shape_runs<2> runs{{out, in}};
+    // The last two dimensions are contiguous in both shapes
+    EXPECT(runs.length() == 20);
+    EXPECT(run_offsets<2>({out, in}) == element_offsets<2>({out, in}));
+}
+
+TEST_CASE(shape_runs_broadcast)
+{
+    migraphx::shape out{migraphx::shape::float_type, {4, 3, 8}};
+    migraphx::shape in{migraphx::shape::float_type, {4, 3, 8}, {0, 1, 0}};
+    migraphx::shape_runs<2> runs{{out, in}};
+    EXPECT(runs.length() == 8);
+    EXPECT(runs.strides() == std::array<std::size_t, 2>{1, 0});
+    EXPECT(run_offsets<2>({out, in}) == element_offsets<2>({out, in}));
+}
+
+TEST_CASE(shape_runs_sliced)
+{
+    migraphx::shape out{migraphx::shape::float_type, {3, 1, 2, 4}};
+    migraphx::shape in{migraphx::shape::float_type, {3, 1, 2, 4}, {40, 40, 8, 1}};
+    migraphx::shape_runs<2> runs{{out, in}};
+    EXPECT(runs.length() == 4);
+    EXPECT(run_offsets<2>({out, in}) == element_offsets<2>({out, in}));
+}
+
+TEST_CASE(shape_runs_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type};
+    migraphx::shape_runs<1> runs{{s}};
+    EXPECT(runs.length() == 1);
+    EXPECT(run_offsets<1>({s}) == element_offsets<1>({s}));
+}
+
+TEST_CASE(shape_runs_empty)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 0, 3}};
+    migraphx::shape_runs<1> runs{{s}};
+    EXPECT(runs.length() == 0);
+    std::size_t n = 0;
+    runs.for_each([&](const auto&) { n++; });
+    EXPECT(n == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
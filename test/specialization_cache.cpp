@@ -0,0 +1,197 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/literal.hpp>
+#include <test.hpp>
+#include <atomic>
+#include <future>
+#include <map>
+
+static migraphx::program make_dynamic_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 8}, {4, 4}}};
+    auto x   = mm->add_parameter("x", s);
+    auto lit = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {1}}, {-2}});
+    auto b   = mm->add_instruction(migraphx::make_op("multibroadcast"), lit, x);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, b);
+    mm->add_instruction(migraphx::make_op("relu"), add);
+    return p;
+}
+
+static migraphx::parameter_map make_params(std::size_t batch)
+{
+    migraphx::shape s{migraphx::shape::float_type, {batch, 4}};
+    return {{"x", migraphx::generate_argument(s, batch)}};
+}
+
+TEST_CASE(specialize_shapes)
+{
+    auto p = migraphx::specialization_cache::specialize(make_dynamic_program(), make_params(3));
+    migraphx::shape s{migraphx::shape::float_type, {3, 4}};
+    EXPECT(p.get_parameter_shape("x") == s);
+    EXPECT(p.get_output_shapes() == std::vector<migraphx::shape>{s});
+}
+
+TEST_CASE(specialize_out_of_range)
+{
+    EXPECT(test::throws([] {
+        migraphx::specialization_cache::specialize(make_dynamic_program(), make_params(9));
+    }));
+}
+
+TEST_CASE(specializations_eval)
+{
+    auto dynamic = make_dynamic_program();
+    dynamic.compile(migraphx::make_target("ref"));
+
+    auto p = make_dynamic_program();
+    migraphx::compile_options options;
+    options.max_specializations = 2;
+    p.compile(migraphx::make_target("ref"), options);
+    EXPECT(p.is_compiled());
+    for(std::size_t batch : {1, 2, 1, 3, 2})
+    {
+        auto params = make_params(batch);
+        EXPECT(p.eval(params).back() == dynamic.eval(params).back());
+    }
+    auto stats = p.get_specialization_stats();
+    EXPECT(stats.hits == 1);
+    EXPECT(stats.misses == 4);
+    // Batch 2 is evicted when batch 3 is compiled, and then batch 1 when batch 2 is compiled again
+    EXPECT(stats.evictions == 2);
+}
+
+TEST_CASE(specializations_static_program)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 4}});
+    mm->add_instruction(migraphx::make_op("relu"), x);
+    migraphx::compile_options options;
+    options.max_specializations = 2;
+    p.compile(migraphx::make_target("ref"), options);
+    std::ignore = p.eval(make_params(2));
+    EXPECT(p.get_specialization_stats().misses == 0);
+}
+
+TEST_CASE(specializations_to_value)
+{
+    auto p = make_dynamic_program();
+    migraphx::compile_options options;
+    options.max_specializations = 2;
+    p.compile(migraphx::make_target("ref"), options);
+    auto params = make_params(2);
+    auto result = p.eval(params).back();
+
+    // The program is saved with its dynamic module, so it is loaded uncompiled
+    migraphx::program p2;
+    p2.from_value(p.to_value());
+    EXPECT(not p2.is_compiled());
+    EXPECT(p2.get_parameter_shape("x").dynamic());
+    p2.compile(migraphx::make_target("ref"), options);
+    EXPECT(p2.eval(params).back() == result);
+}
+
+// Blocks compiling the program for the batch size until it is released
+struct blocking_pass
+{
+    std::size_t batch;
+    std::shared_ptr<std::promise<void>> started;
+    std::shared_future<void> release;
+    std::shared_ptr<std::atomic<std::size_t>> compiles;
+
+    std::string name() const { return "blocking_pass"; }
+    void apply(migraphx::module& m) const
+    {
+        if(m.get_parameter_shape("x").lens().front() != batch)
+            return;
+        (*compiles)++;
+        started->set_value();
+        release.wait();
+    }
+};
+
+struct blocking_target
+{
+    blocking_pass pass;
+    std::string name() const { return "blocking"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context& ctx,
+                                           const migraphx::compile_options& options) const
+    {
+        auto passes = migraphx::make_target("ref").get_passes(ctx, options);
+        passes.insert(passes.begin(), pass);
+        return passes;
+    }
+    migraphx::context get_context() const { return migraphx::make_target("ref").get_context(); }
+};
+
+TEST_CASE(specializations_compile_unlocked)
+{
+    std::promise<void> release;
+    blocking_pass pass{3,
+                       std::make_shared<std::promise<void>>(),
+                       release.get_future().share(),
+                       std::make_shared<std::atomic<std::size_t>>(0)};
+    auto started = pass.started->get_future();
+
+    auto dynamic = make_dynamic_program();
+    dynamic.compile(migraphx::make_target("ref"));
+    std::map<std::size_t, migraphx::argument> expected;
+    for(std::size_t batch : {1, 2, 3})
+        expected[batch] = dynamic.eval(make_params(batch)).back();
+
+    auto p = make_dynamic_program();
+    migraphx::compile_options options;
+    options.max_specializations = 4;
+    p.compile(blocking_target{pass}, options);
+    auto eval = [&](std::size_t batch) {
+        return p.eval(make_params(batch)).back() == expected.at(batch);
+    };
+    EXPECT(eval(1));
+
+    auto compiling = std::async(std::launch::async, [&] { return eval(3); });
+    started.wait();
+    auto waiting = std::async(std::launch::async, [&] { return eval(3); });
+    // Other shapes are evaluated while batch 3 compiles
+    auto others = std::async(std::launch::async, [&] { return eval(1) and eval(2); });
+    bool ready  = others.wait_for(std::chrono::seconds{30}) == std::future_status::ready;
+    release.set_value();
+    EXPECT(ready);
+    EXPECT(others.get());
+    EXPECT(compiling.get());
+    EXPECT(waiting.get());
+    EXPECT(pass.compiles->load() == 1);
+
+    auto stats = p.get_specialization_stats();
+    EXPECT(stats.misses == 3);
+    EXPECT(stats.hits == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/par_dfor.hpp>
+#include <migraphx/simple_par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <atomic>
+#include <numeric>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(run_all_tasks)
+{
+    migraphx::thread_pool pool{3};
+    std::vector<std::size_t> result(100, 0);
+    pool.run(result.size(), [&](std::size_t i) { result[i] = i + 1; });
+    std::vector<std::size_t> expected(result.size());
+    std::iota(expected.begin(), expected.end(), 1);
+    EXPECT(result == expected);
+}
+
+TEST_CASE(run_no_workers)
+{
+    migraphx::thread_pool pool{0};
+    EXPECT(pool.size() == 0);
+    EXPECT(pool.max_concurrency() == 1);
+    std::size_t sum = 0;
+    pool.run(10, [&](std::size_t i) { sum += i; });
+    EXPECT(sum == 45);
+}
+
+TEST_CASE(run_repeated)
+{
+    migraphx::thread_pool pool{2};
+    std::atomic<std::size_t> count{0};
+    for(std::size_t i = 0; i < 1000; i++)
+        pool.run(4, [&](std::size_t) { count++; });
+    EXPECT(count.load() == 4000);
+}
+
+TEST_CASE(run_nested)
+{
+    migraphx::thread_pool pool{2};
+    std::atomic<std::size_t> count{0};
+    pool.run(8, [&](std::size_t) { pool.run(8, [&](std::size_t) { count++; }); });
+    EXPECT(count.load() == 64);
+}
+
+TEST_CASE(run_exception)
+{
+    migraphx::thread_pool pool{2};
+    EXPECT(test::throws([&] {
+        pool.run(16, [&](std::size_t i) {
+            if(i == 7)
+                MIGRAPHX_THROW("error");
+        });
+    }));
+    std::atomic<std::size_t> count{0};
+    pool.run(16, [&](std::size_t) { count++; });
+    EXPECT(count.load() == 16);
+}
+
+TEST_CASE(simple_par_for_tid)
+{
+    const std::size_t n = 1024;
+    std::vector<std::size_t> tids(n, 0);
+    migraphx::simple_par_for(n, [&](std::size_t i, std::size_t tid) { tids[i] = tid + 1; });
+    EXPECT(std::all_of(tids.begin(), tids.end(), [&](auto tid) {
+        return tid > 0 and tid <= migraphx::thread_pool::global().max_concurrency();
+    }));
+    EXPECT(std::is_sorted(tids.begin(), tids.end()));
+}
+
+TEST_CASE(par_for_all)
+{
+    const std::size_t n = 4096;
+    std::vector<int> result(n, 0);
+    migraphx::par_for(n, [&](std::size_t i) { result[i]++; });
+    EXPECT(std::all_of(result.begin(), result.end(), [](int x) { return x == 1; }));
+}
+
+TEST_CASE(par_dfor_all)
+{
+    std::vector<int> result(4 * 5 * 6, 0);
+    migraphx::par_dfor(std::size_t{4}, std::size_t{5}, std::size_t{6})(
+        [&](std::size_t i, std::size_t j, std::size_t k) { result[i * 30 + j * 6 + k]++; });
+    EXPECT(std::all_of(result.begin(), result.end(), [](int x) { return x == 1; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
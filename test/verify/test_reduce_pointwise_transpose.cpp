@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// Pointwise operators on both sides of a reduction over a transposed input, so the fused kernel
+// has to handle non-standard strides for the reduced axis and the output
+struct test_reduce_pointwise_transpose : verify_program<test_reduce_pointwise_transpose>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {16, 3, 24}};
+        migraphx::shape bs{migraphx::shape::float_type, {3}};
+        auto x    = mm->add_parameter("x", s);
+        auto b    = mm->add_parameter("b", bs);
+        auto xt   = mm->add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {1, 2, 0}}}), x);
+        auto bb   = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 0}, {"out_lens", {3, 24, 16}}}), b);
+        auto add  = mm->add_instruction(migraphx::make_op("add"), xt, bb);
+        auto sq   = mm->add_instruction(migraphx::make_op("mul"), add, add);
+        auto sum  = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), sq);
+        auto sumb = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", {3, 24, 16}}}), sum);
+        auto sub  = mm->add_instruction(migraphx::make_op("sub"), add, sumb);
+        mm->add_instruction(migraphx::make_op("tanh"), sub);
+        return p;
+    }
+};
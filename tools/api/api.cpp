@@ -38,6 +38,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/pass_profile.hpp>
 #include <array>
 #include <algorithm>
 #include <cstdarg>
@@ -147,6 +148,18 @@ void set_exhaustive_tune_flag(compile_options& options, bool value)
     options.exhaustive_tune = value;
 }
 
+void set_profile_passes(compile_options& options, bool value)
+{
+    options.profile = value ? std::make_shared<pass_profile>() : nullptr;
+}
+
+std::string get_pass_profile(const compile_options& options)
+{
+    if(options.profile == nullptr)
+        return {};
+    return to_json_string(options.profile->to_value());
+}
+
 void set_file_format(file_options& options, const char* format) { options.format = format; }
 
 void set_default_dim_value(onnx_options& options, size_t value)
@@ -287,6 +300,11 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(const execution_session& s, const parameter_map& params)
+{
+    return s.eval(params);
+}
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }